@@ -0,0 +1,376 @@
+#include "batch_reader.h"
+#include "native_common.h"
+#include "proc_reader.h"
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <initializer_list>
+#include <mutex>
+#include <unistd.h>
+
+#if defined(TASKMGR_ENABLE_IO_URING) && TASKMGR_ENABLE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+// IORING_OP_* are enumerators; IO_URING_OP_SUPPORTED arrived with the
+// probe API in the same release as OPENAT/CLOSE (5.6).
+#if defined(__NR_io_uring_setup) && defined(IO_URING_OP_SUPPORTED)
+#define BATCH_READER_HAS_IO_URING 1
+#endif
+#endif
+
+namespace {
+
+constexpr size_t kBatchChunkSize = 32;
+
+// Lays out one slot per request in this thread's arena.
+void assign_slots(std::vector<BatchRead>& reads) {
+    thread_local std::vector<char> arena;
+    size_t total = 0;
+    for (const auto& r : reads) total += r.cap;
+    if (arena.size() < total) arena.resize(total);
+    char* base = arena.data();
+    for (auto& r : reads) {
+        r.data = base;
+        r.size = -1;
+        base += r.cap;
+    }
+}
+
+void batch_read_sync(std::vector<BatchRead>& reads, size_t from) {
+    parallel_for(reads.size() - from, kBatchChunkSize, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = from + begin; i < from + end; ++i) {
+            BatchRead& r = reads[i];
+            r.size = read_file_into(r.path.c_str(), const_cast<char*>(r.data), r.cap);
+        }
+    });
+}
+
+#ifdef BATCH_READER_HAS_IO_URING
+
+constexpr unsigned kRingEntries = 256;
+// A batch takes any idle ring and falls back to the sync reader when all are
+// busy, so the sampler and binder threads never queue behind each other.
+constexpr size_t kRingPoolSize = 4;
+
+struct Uring {
+    int fd = -1;
+    unsigned entries = 0;
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    io_uring_sqe* sqes = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    // Mappings, for teardown.
+    void* sqPtr = nullptr;
+    size_t sqSize = 0;
+    void* cqPtr = nullptr;
+    size_t cqSize = 0;
+    void* sqePtr = nullptr;
+    size_t sqeSize = 0;
+};
+
+struct RingSlot {
+    std::mutex mutex;
+    Uring ring;
+    bool initFailed = false;
+};
+
+RingSlot g_rings[kRingPoolSize];
+// 0: not probed yet, 1: io_uring usable, -1: sync reader only.
+std::atomic<int> g_uring_state{0};
+
+bool ring_supports(int fd, std::initializer_list<int> ops) {
+    constexpr unsigned kProbeOps = 64;
+    size_t len = sizeof(io_uring_probe) + kProbeOps * sizeof(io_uring_probe_op);
+    std::vector<char> storage(len, 0);
+    auto* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+    if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, kProbeOps) < 0) return false;
+    for (int op : ops) {
+        if (op > probe->last_op) return false;
+        if (!(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) return false;
+    }
+    return true;
+}
+
+void ring_destroy(Uring& ring) {
+    if (ring.sqePtr) munmap(ring.sqePtr, ring.sqeSize);
+    if (ring.cqPtr && ring.cqPtr != ring.sqPtr) munmap(ring.cqPtr, ring.cqSize);
+    if (ring.sqPtr) munmap(ring.sqPtr, ring.sqSize);
+    if (ring.fd >= 0) close(ring.fd);
+    ring = Uring{};
+}
+
+// Seccomp on some Android builds turns io_uring_setup into ENOSYS/EPERM;
+// older kernels lack OPENAT/CLOSE. Either way the sync path takes over.
+bool ring_init(Uring& ring) {
+    io_uring_params params{};
+    int fd = (int)syscall(__NR_io_uring_setup, kRingEntries, &params);
+    if (fd < 0) {
+        LOGD("io_uring unavailable (errno=%d), using sync reader", errno);
+        return false;
+    }
+    ring.fd = fd;
+    if (!ring_supports(fd, {IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_CLOSE})) {
+        LOGD("io_uring lacks openat/read/close, using sync reader");
+        ring_destroy(ring);
+        return false;
+    }
+
+    size_t sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single) {
+        if (cqSize > sqSize) sqSize = cqSize;
+        cqSize = sqSize;
+    }
+    void* sqPtr = mmap(nullptr, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (sqPtr == MAP_FAILED) {
+        ring_destroy(ring);
+        return false;
+    }
+    ring.sqPtr = sqPtr;
+    ring.sqSize = sqSize;
+    void* cqPtr = sqPtr;
+    if (!single) {
+        cqPtr = mmap(nullptr, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (cqPtr == MAP_FAILED) {
+            ring_destroy(ring);
+            return false;
+        }
+    }
+    ring.cqPtr = cqPtr;
+    ring.cqSize = cqSize;
+    size_t sqeSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqePtr = mmap(nullptr, sqeSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqePtr == MAP_FAILED) {
+        ring_destroy(ring);
+        return false;
+    }
+    ring.sqePtr = sqePtr;
+    ring.sqeSize = sqeSize;
+
+    char* sq = static_cast<char*>(sqPtr);
+    char* cq = static_cast<char*>(cqPtr);
+    ring.entries = params.sq_entries;
+    ring.sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    ring.sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    ring.sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    ring.sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    ring.sqes = static_cast<io_uring_sqe*>(sqePtr);
+    ring.cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    ring.cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    ring.cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    ring.cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    LOGD("io_uring batch reader ring ready (%u entries)", ring.entries);
+    return true;
+}
+
+// Sets the slot's ring up on first use; the first setup decides for the
+// whole pool whether io_uring is usable. Caller holds slot.mutex.
+bool ring_ready_locked(RingSlot& slot) {
+    if (g_uring_state.load() < 0) {
+        // Another slot's ring failed; this one is not trusted either.
+        if (slot.ring.fd >= 0) ring_destroy(slot.ring);
+        return false;
+    }
+    if (slot.ring.fd >= 0) return true;
+    if (slot.initFailed) return false;
+    bool ok = ring_init(slot.ring);
+    int unknown = 0;
+    if (!g_uring_state.compare_exchange_strong(unknown, ok ? 1 : -1) && !ok) slot.initFailed = true;
+    return ok;
+}
+
+// Moves every available completion into res (by user_data).
+unsigned ring_reap(Uring& ring, std::vector<int>& res) {
+    unsigned head = *ring.cqHead;
+    unsigned cqTail = __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE);
+    unsigned reaped = 0;
+    while (head != cqTail) {
+        const io_uring_cqe& cqe = ring.cqes[head & *ring.cqMask];
+        if (cqe.user_data < res.size()) res[cqe.user_data] = cqe.res;
+        ++head;
+        ++reaped;
+    }
+    __atomic_store_n(ring.cqHead, head, __ATOMIC_RELEASE);
+    return reaped;
+}
+
+// Submits count prepared SQEs and waits for all of their completions.
+// res[i] receives the result of the SQE whose user_data is i. On failure
+// whatever had completed is still reaped into res.
+bool ring_submit_and_wait(Uring& ring, unsigned count, std::vector<int>& res) {
+    unsigned tail = *ring.sqTail;
+    for (unsigned i = 0; i < count; ++i) {
+        unsigned idx = (tail + i) & *ring.sqMask;
+        ring.sqArray[idx] = idx;
+    }
+    __atomic_store_n(ring.sqTail, tail + count, __ATOMIC_RELEASE);
+
+    unsigned submitted = 0;
+    unsigned completed = 0;
+    while (completed < count) {
+        unsigned toSubmit = count - submitted;
+        int ret = (int)syscall(__NR_io_uring_enter, ring.fd, toSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (ret < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+            LOGE("io_uring_enter failed (errno=%d)", errno);
+            ring_reap(ring, res);
+            return false;
+        }
+        submitted += (unsigned)ret;
+        completed += ring_reap(ring, res);
+    }
+    return true;
+}
+
+io_uring_sqe* ring_sqe(Uring& ring, unsigned i) {
+    unsigned tail = *ring.sqTail;
+    io_uring_sqe* sqe = &ring.sqes[(tail + i) & *ring.sqMask];
+    std::memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+// Opens, reads and closes reads[from, from + count) with three submissions.
+// Every fd the ring opened is closed before returning, by the ring or, once
+// it has failed, here.
+bool ring_read_round(Uring& ring, std::vector<BatchRead>& reads, size_t from, unsigned count) {
+    std::vector<int> fds(count, -1);
+    for (unsigned i = 0; i < count; ++i) {
+        io_uring_sqe* sqe = ring_sqe(ring, i);
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = AT_FDCWD;
+        sqe->addr = (unsigned long long)(uintptr_t)reads[from + i].path.c_str();
+        sqe->open_flags = O_RDONLY | O_CLOEXEC;
+        sqe->user_data = i;
+    }
+    bool ok = ring_submit_and_wait(ring, count, fds);
+
+    std::vector<unsigned> open;
+    open.reserve(count);
+    for (unsigned i = 0; i < count; ++i) {
+        if (fds[i] >= 0) open.push_back(i);
+    }
+
+    // Reads go on from where the last one stopped for files the sync reader
+    // would also read on (seq_files past a page), so both engines return the
+    // same bytes.
+    std::vector<ssize_t> totals(count, -1);
+    for (unsigned i : open) totals[i] = 0;
+    std::vector<unsigned> pending = open;
+    std::vector<int> sizes(count, -1);
+    while (ok && !pending.empty()) {
+        for (unsigned j = 0; j < pending.size(); ++j) {
+            unsigned i = pending[j];
+            BatchRead& r = reads[from + i];
+            io_uring_sqe* sqe = ring_sqe(ring, j);
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = fds[i];
+            sqe->addr = (unsigned long long)(uintptr_t)(r.data + totals[i]);
+            sqe->len = (unsigned)(r.cap - 1 - (size_t)totals[i]);
+            sqe->off = (unsigned long long)totals[i];
+            sqe->user_data = i;
+            sizes[i] = -1;
+        }
+        ok = ring_submit_and_wait(ring, (unsigned)pending.size(), sizes);
+        std::vector<unsigned> more;
+        for (unsigned i : pending) {
+            if (sizes[i] < 0) {
+                totals[i] = -1;
+                continue;
+            }
+            size_t wanted = reads[from + i].cap - 1 - (size_t)totals[i];
+            totals[i] += sizes[i];
+            if (seq_read_continues((size_t)sizes[i], wanted)) more.push_back(i);
+        }
+        pending.swap(more);
+    }
+
+    constexpr int kNotClosed = INT_MIN;
+    std::vector<int> closed(count, kNotClosed);
+    if (ok && !open.empty()) {
+        for (unsigned j = 0; j < open.size(); ++j) {
+            io_uring_sqe* sqe = ring_sqe(ring, j);
+            sqe->opcode = IORING_OP_CLOSE;
+            sqe->fd = fds[open[j]];
+            sqe->user_data = open[j];
+        }
+        ok = ring_submit_and_wait(ring, (unsigned)open.size(), closed);
+    }
+    // Only what the ring did not close, so no fd is closed twice.
+    for (unsigned i : open) {
+        if (closed[i] == kNotClosed) close(fds[i]);
+    }
+    if (!ok) return false;
+
+    for (unsigned i = 0; i < count; ++i) {
+        BatchRead& r = reads[from + i];
+        if (totals[i] >= 0) {
+            const_cast<char*>(r.data)[totals[i]] = '\0';
+            r.size = totals[i];
+        }
+    }
+    return true;
+}
+
+// Runs the batch on an idle pooled ring. False when no ring could take it,
+// leaving reads untouched for the sync reader.
+bool ring_batch_read(std::vector<BatchRead>& reads) {
+    for (RingSlot& slot : g_rings) {
+        if (g_uring_state.load() < 0) return false;
+        std::unique_lock<std::mutex> lock(slot.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || !ring_ready_locked(slot)) continue;
+
+        size_t from = 0;
+        while (from < reads.size()) {
+            unsigned count = (unsigned)std::min<size_t>(slot.ring.entries, reads.size() - from);
+            if (!ring_read_round(slot.ring, reads, from, count)) {
+                // A ring that misbehaves once is not trusted again.
+                g_uring_state = -1;
+                ring_destroy(slot.ring);
+                break;
+            }
+            from += count;
+        }
+        if (from < reads.size()) batch_read_sync(reads, from);
+        return true;
+    }
+    return false;
+}
+
+#endif // BATCH_READER_HAS_IO_URING
+
+} // namespace
+
+void batch_read(std::vector<BatchRead>& reads) {
+    if (reads.empty()) return;
+    assign_slots(reads);
+
+#ifdef BATCH_READER_HAS_IO_URING
+    if (ring_batch_read(reads)) return;
+#endif
+
+    batch_read_sync(reads, 0);
+}
+
+const char* batch_read_engine_name() {
+#ifdef BATCH_READER_HAS_IO_URING
+    if (g_uring_state.load() == 0) {
+        std::lock_guard<std::mutex> lock(g_rings[0].mutex);
+        ring_ready_locked(g_rings[0]);
+    }
+    if (g_uring_state.load() > 0) return "io_uring";
+#endif
+    return "sync";
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sys/types.h>
+
+// One file to read as part of a batch. cap bounds the bytes kept for it.
+struct BatchRead {
+    std::string path;
+    size_t cap = 1024;
+    ssize_t size = -1;
+    const char* data = nullptr;
+
+    bool ok() const { return size > 0; }
+    std::string_view view() const {
+        return ok() ? std::string_view(data, (size_t)size) : std::string_view();
+    }
+};
+
+// Reads every request in one batch. Results are NUL-terminated and live in a
+// per-thread arena, valid until the next batch_read() on the same thread.
+//
+// When the kernel allows it, the whole batch goes through io_uring: one
+// io_uring_enter() each to open, read and close up to a ring's worth of
+// files, plus another read round while any seq_file has more pages (the
+// seq_read_continues() rule). Otherwise the synchronous reader runs on the
+// worker pool. Either way a file longer than cap - 1 bytes is truncated.
+void batch_read(std::vector<BatchRead>& reads);
+
+// "io_uring" or "sync"; probes the kernel on first use.
+const char* batch_read_engine_name();
@@ -1,33 +1,26 @@
 #include "battery_stats.h"
 #include "native_utils.h"
+#include "proc_reader.h"
 
 #include <algorithm>
 #include <sstream>
 
 namespace {
 
-long long read_ll(const std::string& path) {
-    std::string text = trim(read_first_line(path));
-    if (text.empty()) return -1;
-    try {
-        return std::stoll(text);
-    } catch (...) {
-        return -1;
-    }
+long long read_ll(std::string_view path) {
+    long long value = -1;
+    if (!cached_read_ll(path, value)) return -1;
+    return value;
 }
 
-int read_int(const std::string& path) {
-    std::string text = trim(read_first_line(path));
-    if (text.empty()) return -1;
-    try {
-        return std::stoi(text);
-    } catch (...) {
-        return -1;
-    }
+int read_int(std::string_view path) {
+    long long value = -1;
+    if (!cached_read_ll(path, value)) return -1;
+    return (int)value;
 }
 
 std::string detect_power_source() {
-    auto is_online = [](const std::string& path) -> bool {
+    auto is_online = [](std::string_view path) -> bool {
         return read_int(path) == 1;
     };
 
@@ -40,37 +33,37 @@ std::string detect_power_source() {
 } // namespace
 
 BatteryInfo read_battery_info() {
-    const std::string base = "/sys/class/power_supply/battery/";
+    constexpr std::string_view base = "/sys/class/power_supply/battery/";
     BatteryInfo info;
 
-    info.type = trim(read_first_line(base + "type"));
-    info.status = trim(read_first_line(base + "status"));
+    info.type = trim(cached_read_first_line(StackPath{base, "type"}));
+    info.status = trim(cached_read_first_line(StackPath{base, "status"}));
     info.powerSource = detect_power_source();
-    info.tempDeciC = read_int(base + "temp");
-    info.voltageNowUv = std::max(0LL, read_ll(base + "voltage_now"));
-    info.currentNowUa = read_ll(base + "current_now");
-    info.powerNowUw = std::max(0LL, read_ll(base + "power_now"));
-    info.chargeType = trim(read_first_line(base + "charge_type"));
-    info.cycleCount = read_int(base + "cycle_count");
-    info.technology = trim(read_first_line(base + "technology"));
+    info.tempDeciC = read_int(StackPath{base, "temp"});
+    info.voltageNowUv = std::max(0LL, read_ll(StackPath{base, "voltage_now"}));
+    info.currentNowUa = read_ll(StackPath{base, "current_now"});
+    info.powerNowUw = std::max(0LL, read_ll(StackPath{base, "power_now"}));
+    info.chargeType = trim(cached_read_first_line(StackPath{base, "charge_type"}));
+    info.cycleCount = read_int(StackPath{base, "cycle_count"});
+    info.technology = trim(cached_read_first_line(StackPath{base, "technology"}));
 
-    long long ttfNow = read_ll(base + "time_to_full_now");
-    long long ttfAvg = read_ll(base + "time_to_full_avg");
-    long long tteAvg = read_ll(base + "time_to_empty_avg");
+    long long ttfNow = read_ll(StackPath{base, "time_to_full_now"});
+    long long ttfAvg = read_ll(StackPath{base, "time_to_full_avg"});
+    long long tteAvg = read_ll(StackPath{base, "time_to_empty_avg"});
     info.timeToFullSec = (ttfNow >= 0) ? ttfNow : ttfAvg;
     info.timeToEmptySec = tteAvg;
 
-    long long now = read_ll(base + "charge_now");
-    long long full = read_ll(base + "charge_full");
-    if (full <= 0) full = read_ll(base + "charge_full_design");
+    long long now = read_ll(StackPath{base, "charge_now"});
+    long long full = read_ll(StackPath{base, "charge_full"});
+    if (full <= 0) full = read_ll(StackPath{base, "charge_full_design"});
     if (now > 0 || full > 0) {
         info.chargeNow = std::max(0LL, now);
         info.chargeFull = std::max(0LL, full);
         info.chargeUnit = "uAh";
     } else {
-        now = read_ll(base + "energy_now");
-        full = read_ll(base + "energy_full");
-        if (full <= 0) full = read_ll(base + "energy_full_design");
+        now = read_ll(StackPath{base, "energy_now"});
+        full = read_ll(StackPath{base, "energy_full"});
+        if (full <= 0) full = read_ll(StackPath{base, "energy_full_design"});
         if (now > 0 || full > 0) {
             info.chargeNow = std::max(0LL, now);
             info.chargeFull = std::max(0LL, full);
@@ -78,7 +71,7 @@ BatteryInfo read_battery_info() {
         }
     }
 
-    info.levelPercent = read_int(base + "capacity");
+    info.levelPercent = read_int(StackPath{base, "capacity"});
     if (info.levelPercent < 0 && info.chargeNow > 0 && info.chargeFull > 0) {
         double pct = (double)info.chargeNow * 100.0 / (double)info.chargeFull;
         info.levelPercent = (int)(pct + 0.5);
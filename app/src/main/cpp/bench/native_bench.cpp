@@ -0,0 +1,141 @@
+// Host benchmark for the /proc readers, PidTable, the batch reader and the
+// process scan. Built only with -DTASKMGR_BUILD_BENCH=ON on a non-Android
+// host; ctest runs it once with --iterations 1 as a smoke test.
+//
+//   native_bench [--iterations N]
+//
+// Prints ns per operation for each case. Exits non-zero when a parser or the
+// table returns something other than what it was fed.
+
+#include "batch_reader.h"
+#include "native_utils.h"
+#include "pid_table.h"
+#include "proc_meminfo.h"
+#include "proc_reader.h"
+#include "proc_stat.h"
+#include "process_detail.h"
+#include "process_scan.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool ok, const char* what) {
+    if (ok) return;
+    fprintf(stderr, "FAIL: %s\n", what);
+    g_failures++;
+}
+
+// Runs fn iterations times and prints the mean cost of one call.
+template <typename Fn>
+void bench(const char* name, int iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) fn();
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    printf("%-32s %12.0f ns/op  (%d iterations)\n", name, double(ns) / iterations, iterations);
+}
+
+// A comm with a space and a ')' is the case the last-')' rule exists for.
+const char kStatLine[] =
+    "1234 (my (odd) app) S 1 1234 0 0 -1 4194560 5120 0 37 0 811 322 0 0 20 0 "
+    "24 0 98765 2147483648 4096 18446744073709551615 0 0 0 0 0 0 0 0 0 0 0 0 17 3 0 0";
+
+void check_parsers() {
+    ProcStat st;
+    check(parse_proc_stat(kStatLine, sizeof(kStatLine) - 1, st), "parse_proc_stat accepts a comm with ')'");
+    check(st.state == 'S' && st.ppid == 1, "parse_proc_stat state/ppid");
+    check(st.minflt == 5120 && st.majflt == 37, "parse_proc_stat faults");
+    check(st.utime == 811 && st.stime == 322, "parse_proc_stat times");
+    check(st.nice == 0 && st.num_threads == 24, "parse_proc_stat nice/threads");
+    check(st.starttime == 98765 && st.rss == 4096, "parse_proc_stat starttime/rss");
+    check(st.processor == 3, "parse_proc_stat processor");
+
+    std::string_view s = "  42 -7 x";
+    long long a = 0;
+    long long b = 0;
+    check(parse_ll(s, a) && parse_ll(s, b) && a == 42 && b == -7, "parse_ll");
+    check(!parse_ll(s, a), "parse_ll rejects a non-number");
+
+    long long kb = 0;
+    check(parse_keyed_ll("MemTotal:    7812345 kB", "MemTotal:", kb) && kb == 7812345, "parse_keyed_ll");
+    check(!parse_keyed_ll("MemFree:  1 kB", "MemTotal:", kb), "parse_keyed_ll key mismatch");
+
+    std::string_view lines = "a b\nc\n";
+    check(next_line(lines) == "a b" && next_line(lines) == "c" && lines.empty(), "next_line");
+
+    std::string longPath(kStackPathMax, 'x');
+    check(std::string_view(StackPath{"/sys/class/net/", "lo", "/operstate"}) == "/sys/class/net/lo/operstate",
+          "StackPath join");
+    check(std::string_view(StackPath{longPath}).empty(), "StackPath overflow is empty");
+}
+
+void check_pid_table() {
+    PidTable table;
+    bool prevSeen = false;
+    for (int pid = 1; pid <= 2000; ++pid) table.touch(pid, 1, prevSeen).procTicks = (unsigned long long)pid;
+    bool carried = true;
+    for (int pid = 1; pid <= 2000; pid += 2) {
+        PidSlot& slot = table.touch(pid, 2, prevSeen);
+        carried = carried && prevSeen && slot.procTicks == (unsigned long long)pid;
+    }
+    check(carried, "PidTable carries state to the next generation");
+    check(table.find(2, 2) == nullptr && table.find(3, 2) != nullptr, "PidTable find by generation");
+    table.touch(2, 4, prevSeen);
+    check(!prevSeen, "PidTable resets a PID missing for a generation");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int iterations = 1000;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (strcmp(argv[i], "--iterations") == 0) iterations = std::max(1, atoi(argv[i + 1]));
+    }
+
+    check_parsers();
+    check_pid_table();
+
+    ProcStat st;
+    bench("parse_proc_stat", iterations * 100, [&] { parse_proc_stat(kStatLine, sizeof(kStatLine) - 1, st); });
+
+    char buf[4096];
+    bench("read_file_into /proc/loadavg", iterations, [&] { read_file_into("/proc/loadavg", buf, sizeof(buf)); });
+    bench("cached_read_into /proc/loadavg", iterations, [&] { cached_read_into("/proc/loadavg", buf, sizeof(buf)); });
+    bench("sample_memory", iterations, [] { sample_memory(); });
+    bench("sample_cpu_stat", iterations, [] { sample_cpu_stat(); });
+
+    bench("PidTable touch x4096", iterations, [] {
+        static PidTable table;
+        static unsigned long long gen = 0;
+        ++gen;
+        bool prevSeen = false;
+        for (int pid = 1; pid <= 4096; ++pid) table.touch(pid * 7, gen, prevSeen);
+    });
+
+    std::vector<int> pids = list_proc_pids();
+    check(!pids.empty(), "list_proc_pids finds processes");
+    std::vector<BatchRead> reads(pids.size());
+    bench("batch_read /proc/<pid>/stat", std::max(1, iterations / 10), [&] {
+        for (size_t i = 0; i < pids.size(); ++i) {
+            reads[i].path = "/proc/" + std::to_string(pids[i]) + "/stat";
+        }
+        batch_read(reads);
+    });
+    printf("  (%zu files per batch, %s)\n", pids.size(), batch_read_engine_name());
+
+    bench("scan_process_snapshot", std::max(1, iterations / 10), [] { scan_process_snapshot(); });
+
+    if (g_failures > 0) {
+        fprintf(stderr, "%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    return 0;
+}
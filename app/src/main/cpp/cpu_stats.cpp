@@ -1,16 +1,27 @@
 #include "cpu_stats.h"
 #include "native_utils.h"
 #include "system_stats.h"
+#include "proc_reader.h"
+#include "process_detail.h"
+#include "batch_reader.h"
+#include "proc_stat.h"
+#include "thermal_registry.h"
+#include "process_scan.h"
 
 #include <dirent.h>
 #include <fstream>
 #include <sstream>
 #include <set>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include <algorithm>
+#include <cctype>
+#include <deque>
 #include <unistd.h>
 #include <limits>
+#include <ctime>
+#include <mutex>
 
 int count_logical_cores_from_online() {
     std::string online = trim(read_first_line("/sys/devices/system/cpu/online"));
@@ -75,6 +86,14 @@ int count_physical_cores() {
     return (int)cores.size();
 }
 
+static long read_cur_freq_khz(const std::string& base) {
+    long long cur = -1;
+    if (!cached_read_ll(StackPath{base, "scaling_cur_freq"}, cur) || cur <= 0) {
+        if (!cached_read_ll(StackPath{base, "cpuinfo_cur_freq"}, cur)) cur = -1;
+    }
+    return (long)cur;
+}
+
 long get_max_freq_khz() {
     long maxFreq = -1;
     DIR* dir = opendir("/sys/devices/system/cpu/cpufreq");
@@ -85,8 +104,7 @@ long get_max_freq_khz() {
                 std::string name = entry->d_name;
                 if (name.rfind("policy", 0) == 0) {
                     std::string base = "/sys/devices/system/cpu/cpufreq/" + name + "/";
-                    long cur = read_long_from_file(base + "scaling_cur_freq");
-                    if (cur <= 0) cur = read_long_from_file(base + "cpuinfo_cur_freq");
+                    long cur = read_cur_freq_khz(base);
                     if (cur > maxFreq) maxFreq = cur;
                 }
             }
@@ -105,8 +123,7 @@ long get_max_freq_khz() {
                 std::string idx = name.substr(3);
                 if (idx.empty() || idx.find_first_not_of("0123456789") != std::string::npos) continue;
                 std::string base = "/sys/devices/system/cpu/" + name + "/cpufreq/";
-                long cur = read_long_from_file(base + "scaling_cur_freq");
-                if (cur <= 0) cur = read_long_from_file(base + "cpuinfo_cur_freq");
+                long cur = read_cur_freq_khz(base);
                 if (cur > maxFreq) maxFreq = cur;
             }
         }
@@ -132,65 +149,59 @@ int count_processes() {
     return count;
 }
 
+// The total after the slash in /proc/loadavg ("1/734") is the kernel's
+// nr_threads. Falls back to summing num_threads over /proc/<pid>/stat, read
+// in one batch.
 long count_threads() {
-    DIR* procDir = opendir("/proc");
-    if (!procDir) return 0;
+    std::string_view loadavg = read_file_view("/proc/loadavg");
+    size_t slash = loadavg.find('/');
+    if (slash != std::string_view::npos) {
+        std::string_view rest = loadavg.substr(slash + 1);
+        long long total = 0;
+        if (parse_ll(rest, total) && total > 0) return (long)total;
+    }
+
+    std::vector<int> pids = list_proc_pids();
+    std::vector<BatchRead> reads(pids.size());
+    for (size_t i = 0; i < pids.size(); ++i) {
+        reads[i].path = "/proc/" + std::to_string(pids[i]) + "/stat";
+    }
+    batch_read(reads);
     long total = 0;
-    struct dirent* entry;
-    while ((entry = readdir(procDir)) != nullptr) {
-        if (entry->d_type == DT_DIR) {
-            std::string name = entry->d_name;
-            if (name.empty() || name.find_first_not_of("0123456789") != std::string::npos) continue;
-            std::string taskPath = "/proc/" + name + "/task";
-            DIR* taskDir = opendir(taskPath.c_str());
-            if (!taskDir) continue;
-            struct dirent* t;
-            while ((t = readdir(taskDir)) != nullptr) {
-                if (t->d_type == DT_DIR) {
-                    std::string tid = t->d_name;
-                    if (!tid.empty() && tid.find_first_not_of("0123456789") == std::string::npos) {
-                        total++;
-                    }
-                }
-            }
-            closedir(taskDir);
-        }
+    for (const BatchRead& r : reads) {
+        ProcStat st;
+        if (r.ok() && parse_proc_stat(r.data, (size_t)r.size, st)) total += st.num_threads;
     }
-    closedir(procDir);
     return total;
 }
 
 long get_handles_count() {
-    std::ifstream file("/proc/sys/fs/file-nr");
-    if (!file.is_open()) return 0;
-    long allocated = 0;
-    file >> allocated;
-    return allocated;
+    long long allocated = 0;
+    if (!read_ll_file("/proc/sys/fs/file-nr", allocated)) return 0;
+    return (long)allocated;
 }
 
 long get_uptime_seconds() {
-    std::ifstream file("/proc/uptime");
-    if (!file.is_open()) return 0;
-    double uptime = 0;
-    file >> uptime;
+    // Integer part of the first field; the fraction is irrelevant here.
+    long long uptime = 0;
+    if (!read_ll_file("/proc/uptime", uptime)) return 0;
     return (long)uptime;
 }
 
-int count_cpus_from_list(const std::string& list) {
-    int count = 0;
-    std::stringstream ss(list);
+// Expands a CPU list such as "0 1 2 3" (related_cpus) or "0-3,6" (online).
+std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    std::string normalized = list;
+    std::replace(normalized.begin(), normalized.end(), ',', ' ');
+    std::stringstream ss(normalized);
     std::string token;
     while (ss >> token) {
         size_t dash = token.find('-');
-        if (dash == std::string::npos) {
-            count += 1;
-        } else {
-            int start = std::stoi(token.substr(0, dash));
-            int end = std::stoi(token.substr(dash + 1));
-            if (end >= start) count += (end - start + 1);
-        }
+        int start = std::atoi(token.substr(0, dash).c_str());
+        int end = dash == std::string::npos ? start : std::atoi(token.substr(dash + 1).c_str());
+        for (int cpu = start; cpu <= end && cpu >= 0; ++cpu) cpus.push_back(cpu);
     }
-    return count;
+    return cpus;
 }
 
 int read_smt_active() {
@@ -203,6 +214,8 @@ struct CpuCluster {
     int count;
     long maxFreq;
     std::string key;
+    std::vector<int> cpus;
+    std::string policyPath;
 };
 
 std::vector<CpuCluster> get_clusters_from_policies() {
@@ -222,10 +235,10 @@ std::vector<CpuCluster> get_clusters_from_policies() {
                 if (seen.count(related)) continue;
                 seen.insert(related);
 
-                int count = count_cpus_from_list(related);
+                std::vector<int> cpus = parse_cpu_list(related);
                 long maxFreq = read_long_from_file(base + "cpuinfo_max_freq");
                 if (maxFreq <= 0) maxFreq = read_long_from_file(base + "scaling_max_freq");
-                clusters.push_back({count, maxFreq, related});
+                clusters.push_back({(int)cpus.size(), maxFreq, related, cpus, base});
             }
         }
     }
@@ -263,6 +276,92 @@ std::string build_core_layout_labeled(const std::vector<CpuCluster>& clusters) {
     return ss.str();
 }
 
+struct CoreState {
+    int cpu;
+    bool online;
+    double usage;
+    long freqKHz;
+    int cluster;
+};
+
+static std::mutex g_cpu_usage_mutex;
+static CpuStatCursor g_cpu_usage_cursor;
+
+// Per-core view from one /proc/stat sample. Cores of a policy share a clock,
+// so each policy's scaling_cur_freq is read once for all of them.
+std::vector<CoreState> collect_core_states(const CpuStatSample& stat, const std::vector<double>& usage,
+                                           const std::vector<CpuCluster>& clusters) {
+    size_t n = stat.cpus.size();
+    for (const CpuCluster& c : clusters) {
+        for (int cpu : c.cpus) n = std::max(n, (size_t)cpu + 1);
+    }
+    std::vector<CoreState> cores(n);
+    for (size_t i = 0; i < n; ++i) {
+        bool online = i < stat.online.size() && stat.online[i];
+        double u = (online && i < usage.size()) ? usage[i] : -1.0;
+        cores[i] = {(int)i, online, u, -1, -1};
+    }
+    for (size_t k = 0; k < clusters.size(); ++k) {
+        long cur = -1;
+        for (int cpu : clusters[k].cpus) {
+            cores[cpu].cluster = (int)k;
+            if (!cores[cpu].online) continue;
+            if (cur < 0) cur = read_cur_freq_khz(clusters[k].policyPath);
+            cores[cpu].freqKHz = cur;
+        }
+    }
+    for (CoreState& core : cores) {
+        if (core.online && core.cluster < 0) {
+            core.freqKHz = read_cur_freq_khz("/sys/devices/system/cpu/cpu" + std::to_string(core.cpu) + "/cpufreq/");
+        }
+    }
+    return cores;
+}
+
+void write_cores_json(std::stringstream& ss, const std::vector<CoreState>& cores) {
+    ss << "\"cores\":[";
+    for (size_t i = 0; i < cores.size(); ++i) {
+        const CoreState& core = cores[i];
+        if (i > 0) ss << ",";
+        ss << "{\"cpu\":" << core.cpu << ",\"online\":" << (core.online ? "true" : "false")
+           << ",\"usagePercent\":" << core.usage << ",\"freqKHz\":" << core.freqKHz
+           << ",\"cluster\":" << core.cluster << "}";
+    }
+    ss << "]";
+}
+
+// One entry per cluster, fastest first. The peak core is what shows a pegged
+// prime core that the all-core average hides.
+void write_clusters_json(std::stringstream& ss, const std::vector<CpuCluster>& clusters,
+                         const std::vector<CoreState>& cores) {
+    ss << "\"clusters\":[";
+    for (size_t k = 0; k < clusters.size(); ++k) {
+        int online = 0;
+        double sum = 0.0;
+        double peak = -1.0;
+        int peakCpu = -1;
+        long curFreq = -1;
+        for (int cpu : clusters[k].cpus) {
+            const CoreState& core = cores[cpu];
+            if (!core.online) continue;
+            online++;
+            sum += core.usage;
+            if (core.usage > peak) {
+                peak = core.usage;
+                peakCpu = core.cpu;
+            }
+            curFreq = std::max(curFreq, core.freqKHz);
+        }
+        if (k > 0) ss << ",";
+        ss << "{\"cpus\":\"" << escape_json(clusters[k].key) << "\",\"count\":" << clusters[k].count
+           << ",\"online\":" << online << ",\"maxFreqKHz\":" << clusters[k].maxFreq
+           << ",\"curFreqKHz\":" << curFreq
+           << ",\"usagePercent\":" << (online > 0 ? sum / online : -1.0)
+           << ",\"peakUsagePercent\":" << peak << ",\"peakCpu\":" << peakCpu << "}";
+    }
+    ss << "]";
+}
+
 std::string get_cpu_name_best_effort() {
     std::string soc = trim(get_system_property("ro.soc.model"));
     if (!soc.empty()) return soc;
@@ -294,42 +393,29 @@ struct TempCandidate {
 };
 
 double get_cpu_temp_c(std::string& sourceOut, long& rawOut, std::string& candidatesOut, std::string& unitOut) {
-    DIR* dir = opendir("/sys/class/thermal");
-    if (!dir) return -1.0;
-    struct dirent* entry;
-    std::vector<std::string> include = {"cpu", "cpullc", "qmx", "apss", "tsens", "soc", "cluster", "big", "little", "gold", "prime", "qcom", "msm", "sdm"};
-    std::vector<std::string> exclude = {"battery", "skin", "usb", "charger", "pmic"};
+    std::shared_ptr<const ThermalRegistry> registry = thermal_registry();
     std::vector<TempCandidate> bucketCpu;
     std::vector<TempCandidate> bucketApss;
     std::vector<TempCandidate> bucketSoc;
     std::vector<TempCandidate> bucketOther;
 
-    while ((entry = readdir(dir)) != nullptr) {
-        std::string name = entry->d_name;
-        if (name.rfind("thermal_zone", 0) != 0) continue;
-        std::string base = "/sys/class/thermal/" + name + "/";
-        std::string type = trim(read_first_line(base + "type"));
-        if (type.empty()) continue;
-        std::string typeLower = to_lower(type);
-        if (contains_any(typeLower, exclude)) continue;
-        if (!contains_any(typeLower, include)) continue;
-        if (typeLower.find("hw-trip") != std::string::npos) continue;
-        long raw = read_long_from_file(base + "temp");
-        double c = parse_temp_c(raw);
-        if (c < 0) continue;
-        TempCandidate cand{type, raw, c};
-        if (typeLower.rfind("cpu", 0) == 0 || typeLower.find("cpu") != std::string::npos ||
-            typeLower.find("cpullc") != std::string::npos || typeLower.find("qmx") != std::string::npos) {
+    for (const ThermalSensor& sensor : registry->sensors) {
+        if (sensor.hwmon || !sensor.cpuCandidate) continue;
+        double c = -1.0;
+        long raw = 0;
+        // -1 means "no reading" below, so the CPU picks stay above zero.
+        if (!read_thermal_c(sensor, c, raw) || c <= 0) continue;
+        TempCandidate cand{sensor.type, raw, c};
+        if (sensor.cls == kThermalCpu) {
             bucketCpu.push_back(cand);
-        } else if (typeLower.find("apss") != std::string::npos || typeLower.find("tsens") != std::string::npos) {
+        } else if (sensor.cls == kThermalApss) {
             bucketApss.push_back(cand);
-        } else if (typeLower.find("soc") != std::string::npos) {
+        } else if (sensor.cls == kThermalSoc) {
             bucketSoc.push_back(cand);
         } else {
             bucketOther.push_back(cand);
         }
     }
-    closedir(dir);
 
     auto pick_from_bucket = [&](const std::vector<TempCandidate>& bucket, const std::string& label) -> double {
         if (bucket.empty()) return -1.0;
@@ -371,40 +457,19 @@ double get_cpu_temp_c(std::string& sourceOut, long& rawOut, std::string& candida
     std::string bestSource;
     std::string bestUnit;
     std::string bestCandidates;
-    DIR* hdir = opendir("/sys/class/hwmon");
-    if (!hdir) return -1.0;
-    struct dirent* hentry;
-    while ((hentry = readdir(hdir)) != nullptr) {
-        std::string hname = hentry->d_name;
-        if (hname.rfind("hwmon", 0) != 0) continue;
-        std::string base = "/sys/class/hwmon/" + hname + "/";
-        std::string name = trim(read_first_line(base + "name"));
-        std::string nameLower = to_lower(name);
-        bool excluded = contains_any(nameLower, exclude);
-
-        DIR* fdir = opendir(base.c_str());
-        if (!fdir) continue;
-        struct dirent* fentry;
-        while ((fentry = readdir(fdir)) != nullptr) {
-            std::string fname = fentry->d_name;
-            if (fname.rfind("temp", 0) != 0) continue;
-            if (fname.find("_input") == std::string::npos) continue;
-            std::string path = base + fname;
-            long raw = read_long_from_file(path);
-            double c = parse_temp_c(raw);
-            if (c < 0) continue;
-            bool preferred = !excluded && contains_any(nameLower, {"tsens", "cpu", "soc", "apss", "qcom", "msm", "sdm"});
-            if (preferred || best < 0 || (c > best)) {
-                best = c;
-                bestRaw = raw;
-                bestSource = "hwmon:" + (name.empty() ? (hname + "/" + fname) : (name + "/" + fname));
-                bestUnit = (raw >= 1000) ? "mC" : "C";
-                bestCandidates = fname + "=" + std::to_string(raw);
-            }
+    for (const ThermalSensor& sensor : registry->sensors) {
+        if (!sensor.hwmon) continue;
+        double c = -1.0;
+        long raw = 0;
+        if (!read_thermal_c(sensor, c, raw) || c <= 0) continue;
+        if (sensor.cpuCandidate || best < 0 || (c > best)) {
+            best = c;
+            bestRaw = raw;
+            bestSource = "hwmon:" + sensor.type;
+            bestUnit = (raw >= 1000) ? "mC" : "C";
+            bestCandidates = sensor.tempPath.substr(sensor.tempPath.rfind('/') + 1) + "=" + std::to_string(raw);
         }
-        closedir(fdir);
     }
-    closedir(hdir);
     if (best >= 0) {
         rawOut = bestRaw;
         sourceOut = bestSource;
@@ -415,8 +480,25 @@ double get_cpu_temp_c(std::string& sourceOut, long& rawOut, std::string& candida
     return -1.0;
 }
 
-std::string get_cpu_snapshot_json() {
-    std::string cpuName = get_cpu_name_best_effort();
+// Facts that only change with CPU hotplug, built once per distinct
+// /sys/devices/system/cpu/online and shared by every snapshot until it moves.
+struct CpuTopology {
+    std::string online;
+    std::string cpuName;
+    int logical = 0;
+    int physical = 0;
+    std::vector<CpuCluster> clusters;  // fastest first
+    std::string coreLayout;
+    std::string coreLayoutLabeled;
+};
+
+static std::mutex g_topology_mutex;
+static std::shared_ptr<const CpuTopology> g_topology;
+
+static std::shared_ptr<const CpuTopology> build_cpu_topology(const std::string& online) {
+    auto topo = std::make_shared<CpuTopology>();
+    topo->online = online;
+    topo->cpuName = get_cpu_name_best_effort();
 
     int logical = count_logical_cores_from_online();
     if (logical <= 0) {
@@ -425,17 +507,338 @@ std::string get_cpu_snapshot_json() {
     if (logical <= 0) {
         logical = (int)sysconf(_SC_NPROCESSORS_CONF);
     }
+    topo->logical = logical;
 
-    int physical = logical;
+    topo->physical = logical;
     if (read_smt_active() == 1) {
-        int topo = count_physical_cores();
-        if (topo > 0) physical = topo;
+        int physical = count_physical_cores();
+        if (physical > 0) topo->physical = physical;
+    }
+
+    topo->clusters = get_clusters_from_policies();
+    std::sort(topo->clusters.begin(), topo->clusters.end(), [](const CpuCluster& a, const CpuCluster& b) {
+        return a.maxFreq > b.maxFreq;
+    });
+    topo->coreLayout = build_core_layout(topo->clusters);
+    topo->coreLayoutLabeled = build_core_layout_labeled(topo->clusters);
+    return topo;
+}
+
+// The online mask is one pread on a cached descriptor; everything else is
+// reused until it changes.
+static std::shared_ptr<const CpuTopology> cpu_topology() {
+    std::string online = trim(cached_read_first_line("/sys/devices/system/cpu/online"));
+    std::lock_guard<std::mutex> lock(g_topology_mutex);
+    if (!g_topology || g_topology->online != online) g_topology = build_cpu_topology(online);
+    return g_topology;
+}
+
+// Thermal mitigation. A cluster is capped when its policy's scaling_max_freq
+// sits below cpuinfo_max_freq; devfreq devices (GPU, bus) likewise when
+// max_freq is below their highest available frequency. User and power-HAL
+// policy cap the same way, so a cap counts as thermal only while a cooling
+// device matched to it is engaged. Updated on the CPU snapshot tick, next to
+// the temperature read, and on demand when nothing else has sampled recently.
+struct DevfreqDevice {
+    std::string name;
+    std::string maxFreqPath;
+    long long availableMaxHz = 0;
+};
+
+struct CapReading {
+    std::string source;  // "cluster:<cpus>" or "devfreq:<name>"
+    long long maxFreq = 0;
+    long long capFreq = 0;
+    double cappedPercent = 0.0;
+    bool thermal = false;  // capped while a matched cooling device is engaged
+    std::string coolingDevice;
+    long coolingState = -1;
+    long coolingMaxState = -1;
+};
+
+struct CoolingReading {
+    int index;
+    std::string type;
+    std::string typeLower;
+    long state;
+    long maxState;
+};
+
+struct ThrottleEvent {
+    unsigned long long seq;
+    long long timeMs;
+    bool start;
+    std::string source;
+    std::string detail;
+};
+
+static constexpr size_t kThrottleEventHistory = 64;
+static constexpr long long kThrottleStaleMs = 1000;
+
+static long long monotonic_ms() {
+    struct timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000LL;
+}
+
+static std::mutex g_throttle_mutex;
+static long long g_throttle_taken_at_ms = 0;
+static std::vector<CapReading> g_throttle_caps;
+static std::vector<CoolingReading> g_throttle_active_cooling;
+// Per source: engaged or not, and the update pass that last reported it.
+struct ThrottleSourceState {
+    bool engaged = false;
+    unsigned long long pass = 0;
+};
+static std::unordered_map<std::string, ThrottleSourceState> g_throttle_sources;
+static unsigned long long g_throttle_pass = 0;
+static std::deque<ThrottleEvent> g_throttle_events;
+static unsigned long long g_throttle_seq = 0;
+static unsigned long long g_devfreq_generation = 0;
+static std::vector<DevfreqDevice> g_devfreq_devices;
+
+static void discover_devfreq_locked() {
+    g_devfreq_devices.clear();
+    DIR* dir = opendir("/sys/class/devfreq");
+    if (!dir) return;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name = entry->d_name;
+        if (name.empty() || name[0] == '.') continue;
+        std::string base = "/sys/class/devfreq/" + name + "/";
+        std::string available = read_first_line(base + "available_frequencies");
+        std::stringstream ss(available);
+        long long freq = 0;
+        long long top = 0;
+        while (ss >> freq) top = std::max(top, freq);
+        if (top <= 0) continue;
+        g_devfreq_devices.push_back({name, base + "max_freq", top});
+    }
+    closedir(dir);
+}
+
+static double capped_percent(long long maxFreq, long long capFreq) {
+    if (maxFreq <= 0 || capFreq <= 0 || capFreq >= maxFreq) return 0.0;
+    return (1.0 - double(capFreq) / double(maxFreq)) * 100.0;
+}
+
+// Trailing number of a cooling device type such as "thermal-cpufreq-1" or
+// "cpufreq-cpu4", or -1.
+static int trailing_number(const std::string& s) {
+    size_t end = s.size();
+    size_t start = end;
+    while (start > 0 && std::isdigit((unsigned char)s[start - 1])) --start;
+    if (start == end) return -1;
+    return std::atoi(s.c_str() + start);
+}
+
+// cpufreq cooling devices are named after the policy's first CPU on newer
+// kernels ("cpufreq-cpu4") and by registration order, i.e. policy order, on
+// older ones ("thermal-cpufreq-1").
+static int cooling_cluster_index(const std::string& typeLower, const std::vector<CpuCluster>& byFirstCpu) {
+    if (typeLower.find("cpufreq") == std::string::npos) return -1;
+    int n = trailing_number(typeLower);
+    if (n < 0) return -1;
+    if (typeLower.find("cpufreq-cpu") != std::string::npos) {
+        for (size_t k = 0; k < byFirstCpu.size(); ++k) {
+            const std::vector<int>& cpus = byFirstCpu[k].cpus;
+            if (std::find(cpus.begin(), cpus.end(), n) != cpus.end()) return (int)k;
+        }
+        return -1;
+    }
+    return n < (int)byFirstCpu.size() ? n : -1;
+}
+
+// devfreq cooling devices are registered as "devfreq-<device>" or, for GPUs,
+// under a vendor name ("gpu", "kgsl", "mali").
+static bool cooling_matches_devfreq(const std::string& typeLower, const std::string& devLower) {
+    if (typeLower.find(devLower) != std::string::npos) return true;
+    auto gpu = [](const std::string& s) {
+        return s.find("gpu") != std::string::npos || s.find("kgsl") != std::string::npos ||
+               s.find("mali") != std::string::npos;
+    };
+    return gpu(typeLower) && gpu(devLower);
+}
+
+// Keeps the most engaged of the cooling devices matched to r.
+static void attach_cooling(CapReading& r, const CoolingReading& c) {
+    if (!r.coolingDevice.empty() && c.state <= r.coolingState) return;
+    r.coolingDevice = c.type;
+    r.coolingState = c.state;
+    r.coolingMaxState = c.maxState;
+}
+
+static void push_throttle_event_locked(const std::string& source, bool engaged, const std::string& detail,
+                                      long long now) {
+    g_throttle_events.push_back({++g_throttle_seq, now, engaged, source, detail});
+    while (g_throttle_events.size() > kThrottleEventHistory) g_throttle_events.pop_front();
+}
+
+static void note_throttle_locked(const std::string& source, bool engaged, const std::string& detail, long long now) {
+    ThrottleSourceState& state = g_throttle_sources[source];
+    state.pass = g_throttle_pass;
+    if (state.engaged == engaged) return;
+    state.engaged = engaged;
+    push_throttle_event_locked(source, engaged, detail, now);
+}
+
+// Sources this pass did not report went away with a rescan (a cooling
+// device or devfreq device unregistered, a cluster offlined); one still
+// engaged gets its end event here rather than never.
+static void prune_throttle_sources_locked(long long now) {
+    for (auto it = g_throttle_sources.begin(); it != g_throttle_sources.end();) {
+        if (it->second.pass == g_throttle_pass) {
+            ++it;
+            continue;
+        }
+        if (it->second.engaged) push_throttle_event_locked(it->first, false, "source removed", now);
+        it = g_throttle_sources.erase(it);
+    }
+}
+
+static void update_thermal_throttle_locked(const std::vector<CpuCluster>& clusters) {
+    long long now = monotonic_ms();
+    ++g_throttle_pass;
+    std::shared_ptr<const ThermalRegistry> registry = thermal_registry();
+    if (g_devfreq_generation != registry->generation) {
+        discover_devfreq_locked();
+        g_devfreq_generation = registry->generation;
+    }
+
+    std::vector<CpuCluster> byFirstCpu = clusters;
+    std::sort(byFirstCpu.begin(), byFirstCpu.end(), [](const CpuCluster& a, const CpuCluster& b) {
+        int fa = a.cpus.empty() ? 0 : a.cpus.front();
+        int fb = b.cpus.empty() ? 0 : b.cpus.front();
+        return fa < fb;
+    });
+
+    std::vector<CoolingReading> cooling;
+    std::vector<CoolingReading> active;
+    for (const CoolingDevice& dev : registry->coolingDevices) {
+        long state = 0;
+        if (!read_cooling_state(dev, state)) {
+            // Still registered; a failed read leaves its state as it was.
+            auto it = g_throttle_sources.find("cooling:" + std::to_string(dev.index));
+            if (it != g_throttle_sources.end()) it->second.pass = g_throttle_pass;
+            continue;
+        }
+        CoolingReading c{dev.index, dev.type, to_lower(dev.type), state, dev.maxState};
+        if (state > 0) active.push_back(c);
+        note_throttle_locked("cooling:" + std::to_string(dev.index), state > 0,
+                             dev.type + " state " + std::to_string(state) + "/" + std::to_string(dev.maxState), now);
+        cooling.push_back(std::move(c));
+    }
+
+    std::vector<CapReading> caps;
+    for (const CpuCluster& c : byFirstCpu) {
+        long long cap = -1;
+        cached_read_ll(StackPath{c.policyPath, "scaling_max_freq"}, cap);
+        CapReading r;
+        r.source = "cluster:" + c.key;
+        r.maxFreq = c.maxFreq;
+        r.capFreq = cap;
+        r.cappedPercent = capped_percent(c.maxFreq, cap);
+        caps.push_back(r);
+    }
+    for (const CoolingReading& c : cooling) {
+        int k = cooling_cluster_index(c.typeLower, byFirstCpu);
+        if (k >= 0) attach_cooling(caps[k], c);
+    }
+
+    for (const DevfreqDevice& dev : g_devfreq_devices) {
+        long long cap = -1;
+        cached_read_ll(dev.maxFreqPath, cap);
+        CapReading r;
+        r.source = "devfreq:" + dev.name;
+        r.maxFreq = dev.availableMaxHz;
+        r.capFreq = cap;
+        r.cappedPercent = capped_percent(dev.availableMaxHz, cap);
+        std::string nameLower = to_lower(dev.name);
+        for (const CoolingReading& c : cooling) {
+            if (cooling_cluster_index(c.typeLower, byFirstCpu) < 0 && cooling_matches_devfreq(c.typeLower, nameLower)) {
+                attach_cooling(r, c);
+            }
+        }
+        caps.push_back(r);
+    }
+
+    for (CapReading& r : caps) {
+        r.thermal = r.cappedPercent > 0.0 && r.coolingState > 0;
+        std::stringstream detail;
+        detail << "capped " << (long)(r.cappedPercent + 0.5) << "%";
+        if (r.thermal) detail << " by " << r.coolingDevice;
+        note_throttle_locked(r.source, r.thermal, detail.str(), now);
+    }
+    prune_throttle_sources_locked(now);
+
+    g_throttle_caps = std::move(caps);
+    g_throttle_active_cooling = std::move(active);
+    g_throttle_taken_at_ms = now;
+}
+
+void update_thermal_throttle(const std::vector<CpuCluster>& clusters) {
+    std::lock_guard<std::mutex> lock(g_throttle_mutex);
+    update_thermal_throttle_locked(clusters);
+}
+
+std::string get_thermal_throttle_json(unsigned long long sinceSeq) {
+    std::lock_guard<std::mutex> lock(g_throttle_mutex);
+    // The CPU snapshot tick normally keeps this fresh.
+    if (g_throttle_taken_at_ms == 0 || monotonic_ms() - g_throttle_taken_at_ms >= kThrottleStaleMs) {
+        update_thermal_throttle_locked(cpu_topology()->clusters);
     }
 
-    double usage = getGlobalCpuUsage();
-    long maxFreq = get_max_freq_khz();
-    int processes = count_processes();
-    long threads = count_threads();
+    std::stringstream ss;
+    ss << "{";
+    ss << "\"timestampMs\":" << g_throttle_taken_at_ms << ",";
+    ss << "\"seq\":" << g_throttle_seq << ",";
+    ss << "\"caps\":[";
+    for (size_t i = 0; i < g_throttle_caps.size(); ++i) {
+        const CapReading& r = g_throttle_caps[i];
+        if (i > 0) ss << ",";
+        ss << "{\"source\":\"" << escape_json(r.source) << "\",";
+        ss << "\"maxFreq\":" << r.maxFreq << ",";
+        ss << "\"capFreq\":" << r.capFreq << ",";
+        ss << "\"cappedPercent\":" << r.cappedPercent << ",";
+        ss << "\"cause\":\"" << (r.cappedPercent <= 0.0 ? "none" : r.thermal ? "thermal" : "policy") << "\",";
+        ss << "\"coolingDevice\":\"" << escape_json(r.coolingDevice) << "\",";
+        ss << "\"coolingState\":" << r.coolingState << ",";
+        ss << "\"coolingMaxState\":" << r.coolingMaxState << "}";
+    }
+    ss << "],";
+    ss << "\"activeCooling\":[";
+    for (size_t i = 0; i < g_throttle_active_cooling.size(); ++i) {
+        if (i > 0) ss << ",";
+        const CoolingReading& c = g_throttle_active_cooling[i];
+        ss << "{\"device\":" << c.index << ",\"type\":\"" << escape_json(c.type) << "\",\"state\":" << c.state
+           << "}";
+    }
+    ss << "],";
+    ss << "\"events\":[";
+    bool first = true;
+    for (const ThrottleEvent& e : g_throttle_events) {
+        if (e.seq <= sinceSeq) continue;
+        if (!first) ss << ",";
+        first = false;
+        ss << "{\"seq\":" << e.seq << ",\"timestampMs\":" << e.timeMs << ",\"kind\":\""
+           << (e.start ? "start" : "end") << "\",\"source\":\"" << escape_json(e.source)
+           << "\",\"detail\":\"" << escape_json(e.detail) << "\"}";
+    }
+    ss << "]";
+    ss << "}";
+    return ss.str();
+}
+
+std::string get_cpu_snapshot_json() {
+    std::shared_ptr<const CpuTopology> topo = cpu_topology();
+    const std::vector<CpuCluster>& clusters = topo->clusters;
+
+    int processes = 0;
+    long threads = 0;
+    if (!recent_scan_counts(processes, threads)) {
+        processes = count_processes();
+        threads = count_threads();
+    }
     long handles = get_handles_count();
     long uptime = get_uptime_seconds();
     std::string tempSource;
@@ -444,31 +847,225 @@ std::string get_cpu_snapshot_json() {
     long tempRaw = 0;
     double tempC = get_cpu_temp_c(tempSource, tempRaw, tempCandidates, tempUnit);
 
-    std::vector<CpuCluster> clusters = get_clusters_from_policies();
-    std::sort(clusters.begin(), clusters.end(), [](const CpuCluster& a, const CpuCluster& b) {
-        return a.maxFreq > b.maxFreq;
-    });
-    std::string coreLayout = build_core_layout(clusters);
-    std::string coreLayoutLabeled = build_core_layout_labeled(clusters);
+    update_thermal_throttle(clusters);
+
+    std::shared_ptr<const CpuStatSample> stat = sample_cpu_stat();
+    double usage = 0.0;
+    std::vector<double> coreUsage;
+    {
+        std::lock_guard<std::mutex> lock(g_cpu_usage_mutex);
+        usage = advance_cpu_cursor_per_core(g_cpu_usage_cursor, *stat);
+        coreUsage = g_cpu_usage_cursor.cpuBusyPercent;
+    }
+    std::vector<CoreState> cores = collect_core_states(*stat, coreUsage, clusters);
+    long maxFreq = -1;
+    for (const CoreState& core : cores) maxFreq = std::max(maxFreq, core.freqKHz);
+    if (maxFreq <= 0) maxFreq = get_max_freq_khz();
 
     std::stringstream ss;
     ss << "{";
-    ss << "\"cpuName\":\"" << escape_json(cpuName) << "\",";
-    ss << "\"coresPhysical\":" << physical << ",";
-    ss << "\"coresLogical\":" << logical << ",";
+    ss << "\"cpuName\":\"" << escape_json(topo->cpuName) << "\",";
+    ss << "\"coresPhysical\":" << topo->physical << ",";
+    ss << "\"coresLogical\":" << topo->logical << ",";
     ss << "\"usagePercent\":" << usage << ",";
     ss << "\"maxFreqKHz\":" << maxFreq << ",";
     ss << "\"processes\":" << processes << ",";
     ss << "\"threads\":" << threads << ",";
     ss << "\"handles\":" << handles << ",";
     ss << "\"uptimeSeconds\":" << uptime << ",";
-    ss << "\"coreLayout\":\"" << escape_json(coreLayout) << "\",";
-    ss << "\"coreLayoutLabeled\":\"" << escape_json(coreLayoutLabeled) << "\",";
+    ss << "\"coreLayout\":\"" << escape_json(topo->coreLayout) << "\",";
+    ss << "\"coreLayoutLabeled\":\"" << escape_json(topo->coreLayoutLabeled) << "\",";
     ss << "\"cpuTempC\":" << tempC << ",";
     ss << "\"cpuTempSource\":\"" << escape_json(tempSource) << "\",";
     ss << "\"cpuTempRaw\":" << tempRaw << ",";
     ss << "\"cpuTempCandidates\":\"" << escape_json(tempCandidates) << "\",";
-    ss << "\"cpuTempUnitAssumption\":\"" << escape_json(tempUnit) << "\"";
+    ss << "\"cpuTempUnitAssumption\":\"" << escape_json(tempUnit) << "\",";
+    write_cores_json(ss, cores);
+    ss << ",";
+    write_clusters_json(ss, clusters, cores);
     ss << "}";
     return ss.str();
 }
+
+// Frequency and idle residency. Both come from cumulative kernel counters, so
+// the fractions cover everything that happened between two calls, not just
+// the instant a frequency happened to be sampled.
+struct IdleStateCounter {
+    unsigned long long timeUs = 0;
+    unsigned long long usage = 0;
+};
+
+struct ResidencyBaseline {
+    long long takenAtMs = 0;
+    // (freqKHz, 10 ms ticks) from time_in_state, per policy path.
+    std::unordered_map<std::string, std::vector<std::pair<long, unsigned long long>>> freq;
+    // Indexed by CPU number, then idle state.
+    std::vector<std::vector<IdleStateCounter>> idle;
+};
+
+static std::mutex g_residency_mutex;
+// One baseline per consumer key, so two screens polling at their own pace
+// each get their own window.
+static std::unordered_map<long long, ResidencyBaseline> g_residency;
+// Idle state names per CPU; the set of states is fixed once a CPU has booted.
+static std::vector<std::vector<std::string>> g_idle_state_names;
+
+static unsigned long long counter_delta(unsigned long long cur, unsigned long long prev) {
+    return cur > prev ? cur - prev : 0;
+}
+
+std::vector<std::pair<long, unsigned long long>> read_time_in_state(const std::string& policyPath) {
+    std::vector<std::pair<long, unsigned long long>> out;
+    std::string_view content = cached_read_view(StackPath{policyPath, "stats/time_in_state"});
+    while (!content.empty()) {
+        std::string_view line = next_line(content);
+        long long freq = 0;
+        unsigned long long ticks = 0;
+        if (parse_ll(line, freq) && parse_ull(line, ticks)) out.push_back({(long)freq, ticks});
+    }
+    return out;
+}
+
+const std::vector<std::string>& idle_state_names_locked(size_t cpu) {
+    if (g_idle_state_names.size() <= cpu) g_idle_state_names.resize(cpu + 1);
+    std::vector<std::string>& names = g_idle_state_names[cpu];
+    if (names.empty()) {
+        std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpuidle/state";
+        for (int k = 0;; ++k) {
+            std::string name = trim(read_first_line(base + std::to_string(k) + "/name"));
+            if (name.empty()) break;
+            names.push_back(name);
+        }
+    }
+    return names;
+}
+
+// The consumer's baseline, dropping the least recently used one to make room.
+static ResidencyBaseline& residency_baseline_locked(long long consumer) {
+    auto it = g_residency.find(consumer);
+    if (it != g_residency.end()) return it->second;
+    if (g_residency.size() >= kResidencyConsumersMax) {
+        auto oldest = std::min_element(g_residency.begin(), g_residency.end(), [](const auto& a, const auto& b) {
+            return a.second.takenAtMs < b.second.takenAtMs;
+        });
+        g_residency.erase(oldest);
+    }
+    return g_residency[consumer];
+}
+
+std::string get_cpu_residency_json(long long consumer) {
+    std::shared_ptr<const CpuTopology> topo = cpu_topology();
+    const std::vector<CpuCluster>& clusters = topo->clusters;
+    std::shared_ptr<const CpuStatSample> stat = sample_cpu_stat();
+    size_t cpuCount = stat->cpus.size();
+    std::vector<int> clusterOf(cpuCount, -1);
+    for (size_t k = 0; k < clusters.size(); ++k) {
+        for (int cpu : clusters[k].cpus) {
+            if ((size_t)cpu >= cpuCount) {
+                cpuCount = (size_t)cpu + 1;
+                clusterOf.resize(cpuCount, -1);
+            }
+            clusterOf[cpu] = (int)k;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(g_residency_mutex);
+    ResidencyBaseline& base = residency_baseline_locked(consumer);
+    ResidencyBaseline current;
+    current.takenAtMs = monotonic_ms();
+    for (const CpuCluster& c : clusters) current.freq[c.policyPath] = read_time_in_state(c.policyPath);
+
+    // Idle counters are two small files per state per core; read them as one batch.
+    std::vector<BatchRead> reads;
+    current.idle.resize(cpuCount);
+    for (size_t cpu = 0; cpu < cpuCount; ++cpu) {
+        bool online = cpu < stat->online.size() && stat->online[cpu];
+        if (!online) continue;
+        size_t states = idle_state_names_locked(cpu).size();
+        current.idle[cpu].resize(states);
+        std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpuidle/state";
+        for (size_t k = 0; k < states; ++k) {
+            BatchRead time;
+            time.path = base + std::to_string(k) + "/time";
+            time.cap = 32;
+            BatchRead usage;
+            usage.path = base + std::to_string(k) + "/usage";
+            usage.cap = 32;
+            reads.push_back(std::move(time));
+            reads.push_back(std::move(usage));
+        }
+    }
+    batch_read(reads);
+    size_t next = 0;
+    for (size_t cpu = 0; cpu < cpuCount; ++cpu) {
+        for (IdleStateCounter& counter : current.idle[cpu]) {
+            std::string_view time = reads[next++].view();
+            std::string_view usage = reads[next++].view();
+            parse_ull(time, counter.timeUs);
+            parse_ull(usage, counter.usage);
+        }
+    }
+
+    bool hasBaseline = base.takenAtMs > 0;
+    long long intervalMs = hasBaseline ? current.takenAtMs - base.takenAtMs : 0;
+
+    std::stringstream ss;
+    ss << "{";
+    ss << "\"intervalMs\":" << intervalMs << ",";
+    ss << "\"clusters\":[";
+    for (size_t k = 0; k < clusters.size(); ++k) {
+        const auto& now = current.freq[clusters[k].policyPath];
+        const auto& prev = base.freq[clusters[k].policyPath];
+        std::vector<unsigned long long> deltas(now.size(), 0);
+        unsigned long long sum = 0;
+        double weighted = 0.0;
+        for (size_t i = 0; i < now.size(); ++i) {
+            // The OPP table only changes with the policy, but match by frequency to be safe.
+            if (i < prev.size() && prev[i].first == now[i].first) deltas[i] = counter_delta(now[i].second, prev[i].second);
+            sum += deltas[i];
+            weighted += double(now[i].first) * double(deltas[i]);
+        }
+        if (k > 0) ss << ",";
+        ss << "{\"cpus\":\"" << escape_json(clusters[k].key) << "\",";
+        ss << "\"maxFreqKHz\":" << clusters[k].maxFreq << ",";
+        ss << "\"available\":" << (now.empty() ? "false" : "true") << ",";
+        ss << "\"avgFreqKHz\":" << (sum > 0 ? (long)(weighted / double(sum)) : -1L) << ",";
+        ss << "\"freqResidency\":[";
+        for (size_t i = 0; i < now.size(); ++i) {
+            if (i > 0) ss << ",";
+            ss << "{\"freqKHz\":" << now[i].first << ",\"fraction\":"
+               << (sum > 0 ? double(deltas[i]) / double(sum) : 0.0) << "}";
+        }
+        ss << "]}";
+    }
+    ss << "],";
+
+    ss << "\"cores\":[";
+    double windowUs = double(intervalMs) * 1000.0;
+    for (size_t cpu = 0; cpu < cpuCount; ++cpu) {
+        bool online = cpu < stat->online.size() && stat->online[cpu];
+        const std::vector<IdleStateCounter>& now = current.idle[cpu];
+        const std::vector<IdleStateCounter>* prev =
+            cpu < base.idle.size() && base.idle[cpu].size() == now.size() ? &base.idle[cpu] : nullptr;
+        double idleTotal = 0.0;
+        if (cpu > 0) ss << ",";
+        ss << "{\"cpu\":" << cpu << ",\"online\":" << (online ? "true" : "false")
+           << ",\"cluster\":" << clusterOf[cpu] << ",\"idleStates\":[";
+        for (size_t k = 0; k < now.size(); ++k) {
+            unsigned long long dt = prev ? counter_delta(now[k].timeUs, (*prev)[k].timeUs) : 0;
+            unsigned long long entries = prev ? counter_delta(now[k].usage, (*prev)[k].usage) : 0;
+            double fraction = windowUs > 0 ? std::min(1.0, double(dt) / windowUs) : 0.0;
+            idleTotal += fraction;
+            if (k > 0) ss << ",";
+            ss << "{\"name\":\"" << escape_json(g_idle_state_names[cpu][k]) << "\",\"fraction\":" << fraction
+               << ",\"entries\":" << entries << "}";
+        }
+        double active = (online && prev && !now.empty() && windowUs > 0) ? std::max(0.0, 1.0 - idleTotal) : -1.0;
+        ss << "],\"activeFraction\":" << active << "}";
+    }
+    ss << "]";
+    ss << "}";
+
+    base = std::move(current);
+    return ss.str();
+}
@@ -3,3 +3,15 @@
 #include <string>
 
 std::string get_cpu_snapshot_json();
+
+// Per-cluster OPP residency and per-core idle-state residency since the
+// previous call with the same consumer key; intervalMs is 0 on a consumer's
+// first call. Callers pick distinct keys so none steals another's window.
+// Past kResidencyConsumersMax keys the least recently used baseline goes.
+constexpr size_t kResidencyConsumersMax = 8;
+std::string get_cpu_residency_json(long long consumer);
+
+// Per-cluster and devfreq frequency caps with their cause ("thermal",
+// "policy" or "none"), engaged cooling devices by index, and thermal
+// throttle start/end events with seq greater than sinceSeq.
+std::string get_thermal_throttle_json(unsigned long long sinceSeq);
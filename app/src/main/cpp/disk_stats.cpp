@@ -1,5 +1,6 @@
 #include "disk_stats.h"
 #include "native_utils.h"
+#include "proc_reader.h"
 
 #include <sys/statvfs.h>
 #include <sstream>
@@ -65,12 +66,12 @@ std::string find_mount_fstype(const std::string& mountPoint) {
 
 bool read_block_stat(const std::string& dev, DiskSample& out) {
     std::string statPath = "/sys/block/" + dev + "/stat";
-    std::string content = read_file_string(statPath);
-    if (content.empty()) return false;
-    std::stringstream ss(content);
+    char buf[256];
+    if (cached_read_into(statPath, buf, sizeof(buf)) <= 0) return false;
+    std::string_view content(buf);
     long long vals[11];
     for (int i = 0; i < 11; ++i) {
-        if (!(ss >> vals[i])) return false;
+        if (!parse_ll(content, vals[i])) return false;
     }
     out.reads = vals[0];
     out.sectorsRead = vals[2];
@@ -1,6 +1,8 @@
 #include "gpu_stats.h"
 #include "native_utils.h"
 #include "native_common.h"
+#include "proc_reader.h"
+#include "thermal_registry.h"
 
 #include <vulkan/vulkan.h>
 #include <dlfcn.h>
@@ -11,7 +13,6 @@
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
-#include <dirent.h>
 #include <cmath>
 #include <limits>
 #include <ctime>
@@ -417,19 +418,19 @@ static VulkanMemorySnapshot get_vulkan_memory_snapshot(std::string& errorOut) {
 }
 
 static double read_gpu_busy_percent() {
-    std::string raw = read_file_string("/sys/class/kgsl/kgsl-3d0/gpu_busy_percentage");
-    int v = parse_first_int(raw);
+    long long v = -1;
+    if (!cached_read_ll("/sys/class/kgsl/kgsl-3d0/gpu_busy_percentage", v)) return -1.0;
     if (v < 0 || v > 100) return -1.0;
     return static_cast<double>(v);
 }
 
 static double read_gpu_busy_from_gpubusy() {
-    std::string raw = read_file_string("/sys/class/kgsl/kgsl-3d0/gpubusy");
-    if (raw.empty()) return -1.0;
-    std::stringstream ss(raw);
+    char buf[64];
+    if (cached_read_into("/sys/class/kgsl/kgsl-3d0/gpubusy", buf, sizeof(buf)) <= 0) return -1.0;
+    std::string_view raw(buf);
     long long busy = 0;
     long long total = 0;
-    if (!(ss >> busy >> total)) return -1.0;
+    if (!parse_ll(raw, busy) || !parse_ll(raw, total)) return -1.0;
     static long long prevBusy = -1;
     static long long prevTotal = -1;
     if (prevBusy < 0 || prevTotal < 0) {
@@ -447,56 +448,45 @@ static double read_gpu_busy_from_gpubusy() {
     return pct;
 }
 
+// GPU's pick of the shared thermal registry, rebuilt when the registry rescans.
 struct GpuThermalZones {
-    bool initialized = false;
-    std::vector<std::string> gpuss;
-    std::vector<std::string> qmx;
-    std::string socd;
+    std::shared_ptr<const ThermalRegistry> registry;
+    std::vector<const ThermalSensor*> gpuss;
+    std::vector<const ThermalSensor*> qmx;
+    const ThermalSensor* socd = nullptr;
 };
 
 static std::mutex g_gpu_thermal_mutex;
 static GpuThermalZones g_gpu_thermal_zones;
 
-static void init_gpu_thermal_zones() {
-    std::lock_guard<std::mutex> lock(g_gpu_thermal_mutex);
-    if (g_gpu_thermal_zones.initialized) return;
-
-    DIR* dir = opendir("/sys/class/thermal");
-    if (!dir) {
-        g_gpu_thermal_zones.initialized = true;
-        return;
-    }
+static void init_gpu_thermal_zones_locked() {
+    std::shared_ptr<const ThermalRegistry> registry = thermal_registry();
+    if (g_gpu_thermal_zones.registry == registry) return;
 
-    struct dirent* entry;
-    while ((entry = readdir(dir)) != nullptr) {
-        std::string name = entry->d_name;
-        if (name.rfind("thermal_zone", 0) != 0) continue;
-        std::string base = "/sys/class/thermal/" + name + "/";
-        std::string type = trim(read_first_line(base + "type"));
-        if (type.empty()) continue;
-        std::string typeLower = lower_str(type);
-        std::string tempPath = base + "temp";
+    GpuThermalZones zones;
+    zones.registry = registry;
+    for (const ThermalSensor& sensor : registry->sensors) {
+        if (sensor.hwmon) continue;
+        const std::string& typeLower = sensor.typeLower;
         if (typeLower.rfind("gpuss", 0) == 0) {
-            g_gpu_thermal_zones.gpuss.push_back(tempPath);
+            zones.gpuss.push_back(&sensor);
         } else if (typeLower.rfind("qmx", 0) == 0) {
-            g_gpu_thermal_zones.qmx.push_back(tempPath);
+            zones.qmx.push_back(&sensor);
         } else if (typeLower.find("soc") != std::string::npos) {
-            if (g_gpu_thermal_zones.socd.empty()) {
-                g_gpu_thermal_zones.socd = tempPath;
+            if (!zones.socd) {
+                zones.socd = &sensor;
             }
         } else if (typeLower == "socd") {
-            g_gpu_thermal_zones.socd = tempPath;
+            zones.socd = &sensor;
         }
     }
-    closedir(dir);
-    g_gpu_thermal_zones.initialized = true;
+    g_gpu_thermal_zones = std::move(zones);
 }
 
-static double read_temp_c_from_path(const std::string& path) {
-    long raw = read_long_from_file(path);
-    if (raw == -1) return std::numeric_limits<double>::quiet_NaN();
-    double c = (raw >= 1000) ? (raw / 1000.0) : (double)raw;
-    if (c < -50 || c > 200) return std::numeric_limits<double>::quiet_NaN();
+static double read_temp_c_from_sensor(const ThermalSensor& sensor) {
+    double c = -1.0;
+    long raw = 0;
+    if (!read_thermal_c(sensor, c, raw)) return std::numeric_limits<double>::quiet_NaN();
     return c;
 }
 
@@ -511,13 +501,12 @@ static double median_of_values(std::vector<double>& values) {
 }
 
 static double get_gpu_temp_c(std::string& sourceOut, std::string& samplesOut) {
-    init_gpu_thermal_zones();
-
     std::vector<double> vals;
     {
         std::lock_guard<std::mutex> lock(g_gpu_thermal_mutex);
-        for (const auto& path : g_gpu_thermal_zones.gpuss) {
-            double v = read_temp_c_from_path(path);
+        init_gpu_thermal_zones_locked();
+        for (const ThermalSensor* sensor : g_gpu_thermal_zones.gpuss) {
+            double v = read_temp_c_from_sensor(*sensor);
             if (!std::isnan(v)) vals.push_back(v);
         }
         if (!vals.empty()) {
@@ -532,8 +521,8 @@ static double get_gpu_temp_c(std::string& sourceOut, std::string& samplesOut) {
         }
 
         vals.clear();
-        for (const auto& path : g_gpu_thermal_zones.qmx) {
-            double v = read_temp_c_from_path(path);
+        for (const ThermalSensor* sensor : g_gpu_thermal_zones.qmx) {
+            double v = read_temp_c_from_sensor(*sensor);
             if (!std::isnan(v)) vals.push_back(v);
         }
         if (!vals.empty()) {
@@ -547,8 +536,8 @@ static double get_gpu_temp_c(std::string& sourceOut, std::string& samplesOut) {
             return median_of_values(vals);
         }
 
-        if (!g_gpu_thermal_zones.socd.empty()) {
-            double v = read_temp_c_from_path(g_gpu_thermal_zones.socd);
+        if (g_gpu_thermal_zones.socd) {
+            double v = read_temp_c_from_sensor(*g_gpu_thermal_zones.socd);
             if (!std::isnan(v)) {
                 sourceOut = "socd";
                 std::stringstream ss;
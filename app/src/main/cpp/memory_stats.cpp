@@ -1,58 +1,40 @@
 #include "memory_stats.h"
 #include "native_utils.h"
+#include "proc_meminfo.h"
+#include "psi.h"
+#include "zram_stats.h"
 
-#include <fstream>
 #include <sstream>
 #include <chrono>
+#include <mutex>
 
-struct MemInfoValues {
-    long memTotalKb = 0;
-    long memAvailableKb = 0;
-    long cachedKb = 0;
-    long compressedKb = 0;
-    long committedKb = 0;
-    long commitLimitKb = 0;
-};
+static std::mutex g_mem_rates_mutex;
+static MemRateCursor g_mem_rates_cursor;
 
-static MemInfoValues read_meminfo() {
-    MemInfoValues out{};
-    std::ifstream memFile("/proc/meminfo");
-    if (!memFile.is_open()) return out;
-    std::string line;
-    while (std::getline(memFile, line)) {
-        std::stringstream ss(line);
-        std::string key;
-        long value = 0;
-        std::string unit;
-        ss >> key >> value >> unit;
-        if (key == "MemTotal:") {
-            out.memTotalKb = value;
-        } else if (key == "MemAvailable:") {
-            out.memAvailableKb = value;
-        } else if (key == "Cached:") {
-            out.cachedKb = value;
-        } else if (key == "Compressed:") {
-            out.compressedKb = value;
-        } else if (key == "Committed_AS:") {
-            out.committedKb = value;
-        } else if (key == "CommitLimit:") {
-            out.commitLimitKb = value;
-        }
+std::string get_memory_snapshot_json() {
+    std::shared_ptr<const MemSample> sample = sample_memory();
+    const MemInfo& info = sample->mem;
+    const VmStat& vm = sample->vm;
+    MemRates rates;
+    {
+        std::lock_guard<std::mutex> lock(g_mem_rates_mutex);
+        rates = advance_mem_rates(g_mem_rates_cursor, *sample);
     }
-    return out;
-}
 
-std::string get_memory_snapshot_json() {
-    MemInfoValues info = read_meminfo();
-    long totalBytes = info.memTotalKb * 1024L;
-    long availableBytes = info.memAvailableKb * 1024L;
-    long cachedBytes = info.cachedKb * 1024L;
+    long totalBytes = (long)info.memTotal * 1024L;
+    long availableBytes = (long)info.memAvailable * 1024L;
+    long cachedBytes = (long)info.cached * 1024L;
     long usedBytes = totalBytes - availableBytes;
     if (usedBytes < 0) usedBytes = 0;
 
-    long compressedBytes = info.compressedKb * 1024L;
-    long committedUsedBytes = info.committedKb * 1024L;
-    long committedLimitBytes = info.commitLimitKb * 1024L;
+    ZramSwapSnapshot zram = read_zram_swap();
+    // Compressed: is a vendor meminfo key; zram's own footprint is the
+    // portable figure.
+    long compressedBytes = zram.zram.empty() ? (long)info.compressed * 1024L : (long)zram.memUsedTotalBytes;
+    long committedUsedBytes = (long)info.committedAs * 1024L;
+    long committedLimitBytes = (long)info.commitLimit * 1024L;
+    long swapTotalBytes = (long)info.swapTotal * 1024L;
+    long swapUsedBytes = info.swapTotal > info.swapFree ? (long)(info.swapTotal - info.swapFree) * 1024L : 0L;
 
     long long timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::steady_clock::now().time_since_epoch()).count();
@@ -66,7 +48,56 @@ std::string get_memory_snapshot_json() {
     ss << "\"compressedBytes\":" << compressedBytes << ",";
     ss << "\"committedUsedBytes\":" << committedUsedBytes << ",";
     ss << "\"committedLimitBytes\":" << committedLimitBytes << ",";
+    ss << "\"swapTotalBytes\":" << swapTotalBytes << ",";
+    ss << "\"swapUsedBytes\":" << swapUsedBytes << ",";
+    ss << "\"swapCachedBytes\":" << (long)info.swapCached * 1024L << ",";
+    ss << "\"buffersBytes\":" << (long)info.buffers * 1024L << ",";
+    ss << "\"shmemBytes\":" << (long)info.shmem * 1024L << ",";
+    ss << "\"anonBytes\":" << (long)info.anonPages * 1024L << ",";
+    ss << "\"mappedBytes\":" << (long)info.mapped * 1024L << ",";
+    ss << "\"activeFileBytes\":" << (long)info.activeFile * 1024L << ",";
+    ss << "\"inactiveFileBytes\":" << (long)info.inactiveFile * 1024L << ",";
+    ss << "\"activeAnonBytes\":" << (long)info.activeAnon * 1024L << ",";
+    ss << "\"inactiveAnonBytes\":" << (long)info.inactiveAnon * 1024L << ",";
+    ss << "\"unevictableBytes\":" << (long)info.unevictable * 1024L << ",";
+    ss << "\"mlockedBytes\":" << (long)info.mlocked * 1024L << ",";
+    ss << "\"dirtyBytes\":" << (long)info.dirty * 1024L << ",";
+    ss << "\"writebackBytes\":" << (long)info.writeback * 1024L << ",";
+    ss << "\"slabBytes\":" << (long)info.slab * 1024L << ",";
+    ss << "\"slabReclaimableBytes\":" << (long)info.sReclaimable * 1024L << ",";
+    ss << "\"kernelStackBytes\":" << (long)info.kernelStack * 1024L << ",";
+    ss << "\"pageTablesBytes\":" << (long)info.pageTables * 1024L << ",";
+    ss << "\"vmallocUsedBytes\":" << (long)info.vmallocUsed * 1024L << ",";
+    ss << "\"zswapBytes\":" << (long)info.zswap * 1024L << ",";
+    ss << "\"zram\":" << zram_swap_json(zram, rates.pswpin, rates.pswpout) << ",";
+    ss << "\"vmstat\":{";
+    ss << "\"pgfault\":" << vm.pgfault << ",";
+    ss << "\"pgmajfault\":" << vm.pgmajfault << ",";
+    ss << "\"pswpin\":" << vm.pswpin << ",";
+    ss << "\"pswpout\":" << vm.pswpout << ",";
+    ss << "\"pgscanKswapd\":" << vm.pgscanKswapd << ",";
+    ss << "\"pgscanDirect\":" << vm.pgscanDirect << ",";
+    ss << "\"pgstealKswapd\":" << vm.pgstealKswapd << ",";
+    ss << "\"pgstealDirect\":" << vm.pgstealDirect << ",";
+    ss << "\"workingsetRefault\":" << vm.workingsetRefault << ",";
+    ss << "\"allocstall\":" << vm.allocstall << ",";
+    ss << "\"oomKill\":" << vm.oomKill;
+    ss << "},";
+    ss << "\"ratesPerSec\":{";
+    ss << "\"pgpgin\":" << rates.pgpgin << ",";
+    ss << "\"pgpgout\":" << rates.pgpgout << ",";
+    ss << "\"pgfault\":" << rates.pgfault << ",";
+    ss << "\"pgmajfault\":" << rates.pgmajfault << ",";
+    ss << "\"pswpin\":" << rates.pswpin << ",";
+    ss << "\"pswpout\":" << rates.pswpout << ",";
+    ss << "\"pgscan\":" << rates.pgscan << ",";
+    ss << "\"pgsteal\":" << rates.pgsteal << ",";
+    ss << "\"pgscanDirect\":" << rates.pgscanDirect << ",";
+    ss << "\"workingsetRefault\":" << rates.workingsetRefault << ",";
+    ss << "\"allocstall\":" << rates.allocstall;
+    ss << "},";
     ss << "\"timestampMs\":" << timestampMs << ",";
+    ss << "\"pressure\":" << psi_resource_json(kPsiMemory) << ",";
     ss << "\"error\":\"\"";
     ss << "}";
     return ss.str();
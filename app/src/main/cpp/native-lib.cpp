@@ -7,25 +7,106 @@
 #include <vector>
 
 #include "process_scan.h"
+#include "process_table.h"
 #include "process_detail.h"
+#include "process_smaps.h"
+#include "page_cache.h"
 #include "safe_kill.h"
 #include "system_stats.h"
 #include "cpu_stats.h"
+#include "thermal_registry.h"
 #include "gpu_stats.h"
 #include "memory_stats.h"
+#include "psi.h"
 #include "disk_stats.h"
 #include "net_stats.h"
 #include "performance_mini.h"
 #include "battery_stats.h"
+#include "sampler.h"
+
+// Serves the background sampler's copy of a snapshot while some consumer has
+// it collecting that one.
+static std::string sampled_or(unsigned collector, std::string SamplerSnapshot::*field, std::string (*collect)()) {
+    std::shared_ptr<const SamplerSnapshot> snap = sampler_latest();
+    return snap && (snap->collectors & collector) ? (*snap).*field : collect();
+}
 
 extern "C" JNIEXPORT jstring JNICALL
 Java_com_xmodern_taskmgmt_service_NativeBridge_getProcessList(
         JNIEnv* env,
         jobject /* this */) {
-    std::string result = build_process_list();
+    std::string result = build_process_list(*latest_process_snapshot());
     return env->NewStringUTF(result.c_str());
 }
 
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_xmodern_taskmgmt_service_NativeBridge_getProcessListDelta(
+        JNIEnv* env,
+        jobject /* this */,
+        jlong sinceGeneration) {
+    unsigned long long since = sinceGeneration > 0 ? (unsigned long long)sinceGeneration : 0;
+    std::string result = build_process_list_delta(*latest_process_snapshot(), since);
+    return env->NewStringUTF(result.c_str());
+}
+
+extern "C" JNIEXPORT jbyteArray JNICALL
+Java_com_xmodern_taskmgmt_service_NativeBridge_getProcessTable(
+        JNIEnv* env,
+        jobject /* this */,
+        jlong sinceGeneration) {
+    unsigned long long since = sinceGeneration > 0 ? (unsigned long long)sinceGeneration : 0;
+    std::vector<uint8_t> table = encode_process_table(collect_process_list_delta(*latest_process_snapshot(), since));
+    jbyteArray result = env->NewByteArray((jsize)table.size());
+    if (result == nullptr) return nullptr;
+    env->SetByteArrayRegion(result, 0, (jsize)table.size(), reinterpret_cast<const jbyte*>(table.data()));
+    return result;
+}
+
+extern "C" JNIEXPORT jbyteArray JNICALL
+Java_com_xmodern_taskmgmt_service_NativeBridge_queryProcessTable(
+        JNIEnv* env,
+        jobject /* this */,
+        jint sortKey,
+        jboolean descending,
+        jstring filter,
+        jint offset,
+        jint limit) {
+    ProcessQuery query;
+    query.sortKey = (int)sortKey;
+    query.descending = descending == JNI_TRUE;
+    if (filter != nullptr) {
+        const char* filterChars = env->GetStringUTFChars(filter, 0);
+        query.filter = filterChars;
+        env->ReleaseStringUTFChars(filter, filterChars);
+    }
+    query.offset = offset > 0 ? (size_t)offset : 0;
+    query.limit = limit > 0 ? (size_t)limit : 0;
+
+    std::vector<uint8_t> table = encode_process_table(query_process_list(*latest_process_snapshot(), query));
+    jbyteArray result = env->NewByteArray((jsize)table.size());
+    if (result == nullptr) return nullptr;
+    env->SetByteArrayRegion(result, 0, (jsize)table.size(), reinterpret_cast<const jbyte*>(table.data()));
+    return result;
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_xmodern_taskmgmt_service_NativeBridge_setProcessDeltaThresholds(
+        JNIEnv* env,
+        jobject /* this */,
+        jdouble cpuPercent,
+        jlong ramBytes) {
+    set_process_delta_thresholds((double)cpuPercent, (long)ramBytes);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_xmodern_taskmgmt_service_NativeBridge_setPssCollection(
+        JNIEnv* env,
+        jobject /* this */,
+        jboolean enabled,
+        jlong budgetUs) {
+    set_pss_collection(enabled == JNI_TRUE, (long)budgetUs);
+}
+
 extern "C" JNIEXPORT jstring JNICALL
 Java_com_xmodern_taskmgmt_service_NativeBridge_getProcessExtendedInfo(
         JNIEnv* env,
@@ -78,7 +159,8 @@ extern "C" JNIEXPORT jstring JNICALL
 Java_com_xmodern_taskmgmt_service_NativeBridge_getProcessDeepSnapshot(
         JNIEnv* env,
         jobject /* this */,
-        jint pid) {
+        jint pid,
+        jboolean pageCache) {
 
     std::stringstream ss;
     std::string pid_str = std::to_string(pid);
@@ -135,8 +217,15 @@ Java_com_xmodern_taskmgmt_service_NativeBridge_getProcessDeepSnapshot(
        << "MinorPageFaults=" << stats["minflt"] << "|"
        << "MajorPageFaults=" << stats["majflt"] << "\n";
 
+    // --- MEMORY SECTION ---
+    // One smaps pass feeds both the category breakdown and the modules.
+    SmapsBreakdown breakdown;
+    std::vector<MappedModule> mapped;
+    read_smaps_breakdown(pid, breakdown, &mapped);
+    ss << "MEMORY:" << format_smaps_breakdown(breakdown) << "\n";
+
     // --- MODULES SECTION ---
-    std::vector<std::string> modules = get_modules_list(pid_str);
+    std::vector<std::string> modules = get_modules_list(mapped, pageCache == JNI_TRUE);
     ss << "MODULES:";
     for (size_t i = 0; i < modules.size(); ++i) {
         ss << modules[i];
@@ -206,7 +295,34 @@ extern "C" JNIEXPORT jstring JNICALL
 Java_com_xmodern_taskmgmt_service_NativeBridge_getCpuSnapshotJson(
         JNIEnv* env,
         jobject /* this */) {
-    std::string json = get_cpu_snapshot_json();
+    std::string json = sampled_or(kSampleCpu, &SamplerSnapshot::cpuJson, get_cpu_snapshot_json);
+    return env->NewStringUTF(json.c_str());
+}
+
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_xmodern_taskmgmt_service_NativeBridge_getCpuResidencyJson(
+        JNIEnv* env,
+        jobject /* this */,
+        jlong consumer) {
+    // Residency is measured between calls, so it is never served from the sampler.
+    std::string json = get_cpu_residency_json((long long)consumer);
+    return env->NewStringUTF(json.c_str());
+}
+
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_xmodern_taskmgmt_service_NativeBridge_getThermalTableJson(
+        JNIEnv* env,
+        jobject /* this */) {
+    std::string json = get_thermal_table_json();
+    return env->NewStringUTF(json.c_str());
+}
+
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_xmodern_taskmgmt_service_NativeBridge_getThermalThrottleJson(
+        JNIEnv* env,
+        jobject /* this */,
+        jlong sinceSeq) {
+    std::string json = get_thermal_throttle_json(sinceSeq < 0 ? 0ULL : (unsigned long long)sinceSeq);
     return env->NewStringUTF(json.c_str());
 }
 
@@ -222,7 +338,7 @@ extern "C" JNIEXPORT jstring JNICALL
 Java_com_xmodern_taskmgmt_service_NativeBridge_getGpuSnapshotJson(
         JNIEnv* env,
         jobject /* this */) {
-    std::string json = get_gpu_snapshot_json();
+    std::string json = sampled_or(kSampleGpu, &SamplerSnapshot::gpuJson, get_gpu_snapshot_json);
     return env->NewStringUTF(json.c_str());
 }
 
@@ -230,15 +346,75 @@ extern "C" JNIEXPORT jstring JNICALL
 Java_com_xmodern_taskmgmt_service_NativeBridge_getMemorySnapshotJson(
         JNIEnv* env,
         jobject /* this */) {
-    std::string json = get_memory_snapshot_json();
+    std::string json = sampled_or(kSampleMemory, &SamplerSnapshot::memoryJson, get_memory_snapshot_json);
+    return env->NewStringUTF(json.c_str());
+}
+
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_xmodern_taskmgmt_service_NativeBridge_getPageCacheTopJson(
+        JNIEnv* env,
+        jobject /* this */,
+        jint limit) {
+    ProcessQuery query;
+    query.limit = kPageCacheTopProcesses;
+    std::vector<int> pids;
+    for (const ProcessListRow& row : query_process_list(*latest_process_snapshot(), query).rows) {
+        pids.push_back(row.pid);
+    }
+    std::string result = page_cache_top_json(pids, (int)limit);
+    return env->NewStringUTF(result.c_str());
+}
+
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_xmodern_taskmgmt_service_NativeBridge_getPsiSnapshotJson(
+        JNIEnv* env,
+        jobject /* this */) {
+    std::string json = get_psi_snapshot_json();
+    return env->NewStringUTF(json.c_str());
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_xmodern_taskmgmt_service_NativeBridge_addPsiTrigger(
+        JNIEnv* env,
+        jobject /* this */,
+        jint resource,
+        jboolean full,
+        jlong stallUs,
+        jlong windowUs) {
+    if (resource < kPsiCpu || resource > kPsiIo) return -1;
+    return psi_add_trigger((PsiResourceKind)resource, full == JNI_TRUE, (long)stallUs, (long)windowUs);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_xmodern_taskmgmt_service_NativeBridge_removePsiTrigger(
+        JNIEnv* env,
+        jobject /* this */,
+        jint triggerId) {
+    psi_remove_trigger(triggerId);
+}
+
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_xmodern_taskmgmt_service_NativeBridge_waitPsiEvents(
+        JNIEnv* env,
+        jobject /* this */,
+        jlong sinceSeq,
+        jlong timeoutMs) {
+    std::string json = psi_wait_events_json(sinceSeq < 0 ? 0ULL : (unsigned long long)sinceSeq, (long)timeoutMs);
     return env->NewStringUTF(json.c_str());
 }
 
+extern "C" JNIEXPORT jint JNICALL
+Java_com_xmodern_taskmgmt_service_NativeBridge_armKillPressureTrigger(
+        JNIEnv* env,
+        jobject /* this */) {
+    return arm_kill_pressure_trigger();
+}
+
 extern "C" JNIEXPORT jstring JNICALL
 Java_com_xmodern_taskmgmt_service_NativeBridge_getDiskSnapshotJson(
         JNIEnv* env,
         jobject /* this */) {
-    std::string json = get_disk_snapshot_json();
+    std::string json = sampled_or(kSampleDisk, &SamplerSnapshot::diskJson, get_disk_snapshot_json);
     return env->NewStringUTF(json.c_str());
 }
 
@@ -246,7 +422,7 @@ extern "C" JNIEXPORT jstring JNICALL
 Java_com_xmodern_taskmgmt_service_NativeBridge_getNetSnapshotJson(
         JNIEnv* env,
         jobject /* this */) {
-    std::string json = get_net_snapshot_json();
+    std::string json = sampled_or(kSampleNet, &SamplerSnapshot::netJson, get_net_snapshot_json);
     return env->NewStringUTF(json.c_str());
 }
 
@@ -254,7 +430,8 @@ extern "C" JNIEXPORT jstring JNICALL
 Java_com_xmodern_taskmgmt_service_NativeBridge_getPerformanceMiniSnapshotJson(
         JNIEnv* env,
         jobject /* this */) {
-    std::string json = get_performance_mini_snapshot_json();
+    std::string json = sampled_or(kSamplePerformanceMini, &SamplerSnapshot::performanceMiniJson,
+                                  get_performance_mini_snapshot_json);
     return env->NewStringUTF(json.c_str());
 }
 
@@ -262,6 +439,23 @@ extern "C" JNIEXPORT jstring JNICALL
 Java_com_xmodern_taskmgmt_service_NativeBridge_getBatterySnapshotJson(
         JNIEnv* env,
         jobject /* this */) {
-    std::string json = get_battery_snapshot_json();
+    std::string json = sampled_or(kSampleBattery, &SamplerSnapshot::batteryJson, get_battery_snapshot_json);
     return env->NewStringUTF(json.c_str());
 }
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_xmodern_taskmgmt_service_NativeBridge_startSampler(
+        JNIEnv* env,
+        jobject /* this */,
+        jlong intervalMs,
+        jint collectors) {
+    return start_sampler((long)intervalMs, (unsigned)collectors);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_xmodern_taskmgmt_service_NativeBridge_stopSampler(
+        JNIEnv* env,
+        jobject /* this */,
+        jint consumerId) {
+    stop_sampler((int)consumerId);
+}
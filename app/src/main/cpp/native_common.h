@@ -1,7 +1,16 @@
 #pragma once
 
+#define LOG_TAG "SystemManagerNative"
+
+#ifdef __ANDROID__
 #include <android/log.h>
 
-#define LOG_TAG "SystemManagerNative"
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 #define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#else
+// Host builds (native_bench) log errors to stderr and drop debug output.
+#include <cstdio>
+
+#define LOGE(...) (fprintf(stderr, LOG_TAG ": " __VA_ARGS__), fputc('\n', stderr))
+#define LOGD(...) ((void)0)
+#endif
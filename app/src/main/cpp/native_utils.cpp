@@ -1,20 +1,23 @@
 #include "native_utils.h"
 #include "native_common.h"
+#include "proc_reader.h"
 
-#include <fstream>
-#include <sstream>
+#ifdef __ANDROID__
 #include <sys/system_properties.h>
+#endif
+#include <dirent.h>
 #include <array>
 #include <memory>
 #include <cstdio>
 #include <cctype>
+#include <limits>
 
 std::string read_first_line(const std::string& path) {
-    std::ifstream file(path);
-    if (!file.is_open()) return "";
-    std::string line;
-    std::getline(file, line);
-    return line;
+    char buf[4096];
+    ssize_t n = read_file_into(path.c_str(), buf, sizeof(buf));
+    if (n <= 0) return "";
+    std::string_view content(buf, (size_t)n);
+    return std::string(next_line(content));
 }
 
 std::string trim(const std::string& s) {
@@ -25,18 +28,20 @@ std::string trim(const std::string& s) {
 }
 
 std::string get_system_property(const char* key) {
+#ifdef __ANDROID__
     char value[PROP_VALUE_MAX] = {0};
     int len = __system_property_get(key, value);
     if (len > 0) return std::string(value, len);
+#else
+    (void)key;
+#endif
     return "";
 }
 
 long read_long_from_file(const std::string& path) {
-    std::ifstream file(path);
-    if (!file.is_open()) return -1;
-    long value = -1;
-    file >> value;
-    return value;
+    long long value = -1;
+    if (!read_ll_file(path.c_str(), value)) return -1;
+    return (long)value;
 }
 
 std::string escape_json(const std::string& s) {
@@ -78,10 +83,11 @@ bool contains_any(const std::string& s, const std::vector<std::string>& keys) {
     return false;
 }
 
+// NaN outside -50..200 °C; raw values of 1000 or more (either sign) are
+// millidegrees.
 double parse_temp_c(long raw) {
-    if (raw <= 0) return -1.0;
-    double c = (raw >= 1000) ? (raw / 1000.0) : (double)raw;
-    if (c < -50.0 || c > 200.0) return -1.0;
+    double c = (raw >= 1000 || raw <= -1000) ? (raw / 1000.0) : (double)raw;
+    if (c < -50.0 || c > 200.0) return std::numeric_limits<double>::quiet_NaN();
     return c;
 }
 
@@ -100,16 +106,42 @@ std::string execute_shell_command(const char* cmd) {
 }
 
 std::string read_file_string(const std::string& path) {
-    std::ifstream file(path);
-    if (!file.is_open()) return "";
-    std::stringstream ss;
-    ss << file.rdbuf();
-    return ss.str();
+    std::string out;
+    if (!read_file_to_string(path.c_str(), out)) return "";
+    return out;
 }
 
 int parse_first_int(const std::string& s) {
-    std::stringstream ss(s);
-    int v = 0;
-    if (ss >> v) return v;
-    return -1;
+    std::string_view view(s);
+    long long v = 0;
+    if (!parse_ll(view, v)) return -1;
+    return (int)v;
+}
+
+std::vector<int> list_proc_pids() {
+    std::vector<int> pids;
+    DIR* procDir = opendir("/proc");
+    if (procDir == nullptr) {
+        LOGE("Failed to open /proc");
+        return pids;
+    }
+    pids.reserve(1024);
+    struct dirent* entry;
+    while ((entry = readdir(procDir)) != nullptr) {
+        if (entry->d_type != DT_DIR) continue;
+        const char* name = entry->d_name;
+        if (*name == '\0') continue;
+        int pid = 0;
+        bool numeric = true;
+        for (const char* p = name; *p; ++p) {
+            if (*p < '0' || *p > '9') {
+                numeric = false;
+                break;
+            }
+            pid = pid * 10 + (*p - '0');
+        }
+        if (numeric) pids.push_back(pid);
+    }
+    closedir(procDir);
+    return pids;
 }
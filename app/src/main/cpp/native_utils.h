@@ -15,3 +15,4 @@ double parse_temp_c(long raw);
 std::string execute_shell_command(const char* cmd);
 std::string read_file_string(const std::string& path);
 int parse_first_int(const std::string& s);
+std::vector<int> list_proc_pids();
@@ -1,5 +1,6 @@
 #include "net_stats.h"
 #include "native_utils.h"
+#include "proc_reader.h"
 
 #include <sstream>
 #include <string>
@@ -23,39 +24,34 @@ struct NetCounters {
 };
 
 bool read_iface_counters(const std::string& iface, NetCounters& out) {
-    std::string data = read_file_string("/proc/net/dev");
-    if (data.empty()) return false;
-    std::stringstream ss(data);
-    std::string line;
-    while (std::getline(ss, line)) {
-        auto colon = line.find(':');
-        if (colon == std::string::npos) continue;
-        std::string name = trim(line.substr(0, colon));
-        if (name != iface) continue;
-        std::stringstream ls(line.substr(colon + 1));
-        long long rxBytes = 0, rxPackets = 0, rxErr = 0, rxDrop = 0, rxFifo = 0, rxFrame = 0, rxCompressed = 0, rxMulticast = 0;
-        long long txBytes = 0, txPackets = 0, txErr = 0, txDrop = 0, txFifo = 0, txColls = 0, txCarrier = 0, txCompressed = 0;
-        if (!(ls >> rxBytes >> rxPackets >> rxErr >> rxDrop >> rxFifo >> rxFrame >> rxCompressed >> rxMulticast
-                 >> txBytes >> txPackets >> txErr >> txDrop >> txFifo >> txColls >> txCarrier >> txCompressed)) {
-            return false;
+    std::string_view content = cached_read_view("/proc/net/dev");
+    while (!content.empty()) {
+        std::string_view line = next_line(content);
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos) continue;
+        if (trim_view(line.substr(0, colon)) != iface) continue;
+        std::string_view rest = line.substr(colon + 1);
+        long long vals[16];
+        for (int i = 0; i < 16; ++i) {
+            if (!parse_ll(rest, vals[i])) return false;
         }
         out.iface = iface;
-        out.rxBytes = rxBytes;
-        out.txBytes = txBytes;
-        out.rxPackets = rxPackets;
-        out.txPackets = txPackets;
+        out.rxBytes = vals[0];
+        out.rxPackets = vals[1];
+        out.txBytes = vals[8];
+        out.txPackets = vals[9];
         return true;
     }
     return false;
 }
 
 bool iface_is_up(const std::string& iface) {
-    std::string oper = read_first_line("/sys/class/net/" + iface + "/operstate");
+    std::string oper = cached_read_first_line(StackPath{"/sys/class/net/", iface, "/operstate"});
     if (!oper.empty()) {
         std::string lower = to_lower(trim(oper));
         if (lower == "up") return true;
     }
-    std::string carrier = read_first_line("/sys/class/net/" + iface + "/carrier");
+    std::string carrier = cached_read_first_line(StackPath{"/sys/class/net/", iface, "/carrier"});
     if (!carrier.empty()) {
         return trim(carrier) == "1";
     }
@@ -63,19 +59,17 @@ bool iface_is_up(const std::string& iface) {
 }
 
 std::vector<std::string> list_ifaces() {
-    std::string names = read_file_string("/proc/net/dev");
+    std::string_view content = cached_read_view("/proc/net/dev");
     std::vector<std::string> out;
-    if (names.empty()) return out;
-    std::stringstream ss(names);
-    std::string line;
     int lineNo = 0;
-    while (std::getline(ss, line)) {
+    while (!content.empty()) {
+        std::string_view line = next_line(content);
         lineNo++;
         if (lineNo <= 2) continue;
-        auto colon = line.find(':');
-        if (colon == std::string::npos) continue;
-        std::string name = trim(line.substr(0, colon));
-        if (!name.empty()) out.push_back(name);
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos) continue;
+        std::string_view name = trim_view(line.substr(0, colon));
+        if (!name.empty()) out.emplace_back(name);
     }
     return out;
 }
@@ -0,0 +1,270 @@
+#include "page_cache.h"
+#include "native_utils.h"
+#include "proc_reader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+#ifndef __NR_cachestat
+#define __NR_cachestat 451  // same number on every architecture
+#endif
+
+namespace {
+
+// uapi struct cachestat_range / struct cachestat; older NDK headers lack them.
+struct CachestatRange {
+    uint64_t off;
+    uint64_t len;  // 0 = to end of file
+};
+
+struct Cachestat {
+    uint64_t nrCache;
+    uint64_t nrDirty;
+    uint64_t nrWriteback;
+    uint64_t nrEvicted;
+    uint64_t nrRecentlyEvicted;
+};
+
+struct CachedResidency {
+    PageCacheResidency residency;
+    std::list<MappedFileKey>::iterator lru;
+};
+
+std::mutex g_page_cache_mutex;
+std::unordered_map<MappedFileKey, CachedResidency, MappedFileKeyHash> g_page_cache;
+// Most recently used first.
+std::list<MappedFileKey> g_page_cache_lru;
+
+std::mutex g_top_mutex;
+std::string g_top_json;
+int g_top_limit = 0;
+long long g_top_at_ms = 0;
+
+long long now_ms() {
+    struct timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000LL;
+}
+
+long page_size() {
+    static const long size = sysconf(_SC_PAGESIZE) > 0 ? sysconf(_SC_PAGESIZE) : 4096;
+    return size;
+}
+
+// cachestat() arrived in 6.5. It is only tried on kernels that have it, since
+// an unknown syscall may be trapped by seccomp rather than fail with ENOSYS.
+bool kernel_has_cachestat() {
+    struct utsname u{};
+    if (uname(&u) != 0) return false;
+    int major = 0;
+    int minor = 0;
+    if (sscanf(u.release, "%d.%d", &major, &minor) != 2) return false;
+    return major > 6 || (major == 6 && minor >= 5);
+}
+
+std::atomic<bool> g_use_cachestat{kernel_has_cachestat()};
+
+bool cachestat_residency(int fd, PageCacheResidency& out) {
+    CachestatRange range{0, 0};
+    Cachestat cs{};
+    if (syscall(__NR_cachestat, fd, &range, &cs, 0) != 0) {
+        if (errno == ENOSYS || errno == EPERM) g_use_cachestat = false;
+        return false;
+    }
+    out.cachedBytes = (long long)cs.nrCache * page_size();
+    out.dirtyBytes = (long long)cs.nrDirty * page_size();
+    return true;
+}
+
+bool mincore_residency(int fd, long long size, PageCacheResidency& out) {
+    const long pageSize = page_size();
+    thread_local std::vector<unsigned char> vec;
+    vec.resize(kMincoreWindowBytes / (size_t)pageSize);
+
+    long long resident = 0;
+    for (long long off = 0; off < size; off += (long long)kMincoreWindowBytes) {
+        size_t len = (size_t)std::min<long long>((long long)kMincoreWindowBytes, size - off);
+        void* addr = mmap(nullptr, len, PROT_READ, MAP_SHARED, fd, (off_t)off);
+        if (addr == MAP_FAILED) return false;
+        size_t pages = (len + (size_t)pageSize - 1) / (size_t)pageSize;
+        if (mincore(addr, len, vec.data()) == 0) {
+            for (size_t i = 0; i < pages; ++i) resident += vec[i] & 1;
+        }
+        munmap(addr, len);
+    }
+    out.cachedBytes = resident * pageSize;
+    out.dirtyBytes = -1;
+    return true;
+}
+
+PageCacheResidency measure(const MappedModule& m) {
+    PageCacheResidency r;
+    r.measuredAtMs = now_ms();
+    struct stat st;
+    int fd = open_mapped_file(m, st);
+    if (fd < 0) return r;
+    r.sizeBytes = st.st_size;
+    if (r.sizeBytes == 0) {
+        r.ok = true;
+    } else if (g_use_cachestat && cachestat_residency(fd, r)) {
+        r.ok = true;
+    } else {
+        r.ok = mincore_residency(fd, r.sizeBytes, r);
+    }
+    close(fd);
+    return r;
+}
+
+struct MappedFile {
+    MappedModule module;  // path and the first mapping seen
+    int processes = 0;
+    int lastPid = -1;
+    PageCacheResidency residency;
+};
+
+// Adds every module file in one /proc/<pid>/maps to files.
+void collect_maps(int pid, std::string_view maps, std::vector<MappedFile>& files,
+                  std::unordered_map<MappedFileKey, size_t, MappedFileKeyHash>& index) {
+    while (!maps.empty()) {
+        std::string_view line = next_line(maps);
+        std::string_view range = next_token(line);
+        next_token(line);  // perms
+        next_token(line);  // offset
+        std::string_view dev = next_token(line);
+        unsigned long long inode = 0;
+        if (!parse_ull(line, inode) || inode == 0) continue;
+        std::string_view path = trim_view(line);
+        if (path.empty() || path[0] != '/' || !is_module_file(path)) continue;
+        unsigned int major = 0;
+        unsigned int minor = 0;
+        if (!parse_dev(dev, major, minor)) continue;
+
+        MappedFileKey key{((unsigned long long)major << 32) | minor, inode};
+        auto it = index.find(key);
+        if (it == index.end()) {
+            MappedFile f;
+            f.module.path = std::string(path);
+            f.module.pid = pid;
+            f.module.range = std::string(range);
+            f.module.devMajor = major;
+            f.module.devMinor = minor;
+            f.module.inode = inode;
+            it = index.emplace(key, files.size()).first;
+            files.push_back(std::move(f));
+        }
+        MappedFile& f = files[it->second];
+        if (f.lastPid != pid) {
+            f.lastPid = pid;
+            f.processes++;
+        }
+    }
+}
+
+} // namespace
+
+bool file_page_cache(const MappedModule& m, PageCacheResidency& out) {
+    MappedFileKey key = m.key();
+    long long now = now_ms();
+    {
+        std::lock_guard<std::mutex> lock(g_page_cache_mutex);
+        auto it = g_page_cache.find(key);
+        if (it != g_page_cache.end() && now - it->second.residency.measuredAtMs < kPageCacheMaxAgeMs) {
+            g_page_cache_lru.splice(g_page_cache_lru.begin(), g_page_cache_lru, it->second.lru);
+            out = it->second.residency;
+            return out.ok;
+        }
+    }
+    out = measure(m);
+    if (!out.ok) return false;
+    std::lock_guard<std::mutex> lock(g_page_cache_mutex);
+    auto it = g_page_cache.find(key);
+    if (it != g_page_cache.end()) {
+        g_page_cache_lru.splice(g_page_cache_lru.begin(), g_page_cache_lru, it->second.lru);
+        it->second.residency = out;
+        return out.ok;
+    }
+    if (g_page_cache.size() >= kPageCacheEntriesMax) {
+        g_page_cache.erase(g_page_cache_lru.back());
+        g_page_cache_lru.pop_back();
+    }
+    g_page_cache_lru.push_front(key);
+    g_page_cache.emplace(key, CachedResidency{out, g_page_cache_lru.begin()});
+    return out.ok;
+}
+
+const char* page_cache_method() {
+    return g_use_cachestat ? "cachestat" : "mincore";
+}
+
+std::string page_cache_top_json(const std::vector<int>& pids, int limit) {
+    if (limit <= 0) limit = 50;
+    long long now = now_ms();
+    {
+        std::lock_guard<std::mutex> lock(g_top_mutex);
+        if (!g_top_json.empty() && g_top_limit == limit && now - g_top_at_ms < kPageCacheMaxAgeMs) return g_top_json;
+    }
+
+    // Measured without g_top_mutex: a concurrent caller may repeat the work,
+    // but never waits behind the file opens.
+    std::vector<MappedFile> files;
+    std::unordered_map<MappedFileKey, size_t, MappedFileKeyHash> index;
+    int scanned = 0;
+    std::string maps;
+    char path[64];
+    for (int pid : pids) {
+        snprintf(path, sizeof(path), "/proc/%d/maps", pid);
+        if (!read_file_to_string(path, maps)) continue;
+        scanned++;
+        collect_maps(pid, maps, files, index);
+    }
+
+    for (MappedFile& f : files) file_page_cache(f.module, f.residency);
+    // Files that could not be opened as themselves have nothing to rank.
+    files.erase(std::remove_if(files.begin(), files.end(), [](const MappedFile& f) { return !f.residency.ok; }),
+                files.end());
+    std::sort(files.begin(), files.end(), [](const MappedFile& a, const MappedFile& b) {
+        return a.residency.cachedBytes > b.residency.cachedBytes;
+    });
+    if (files.size() > (size_t)limit) files.resize((size_t)limit);
+
+    std::stringstream ss;
+    ss << "{";
+    ss << "\"method\":\"" << page_cache_method() << "\",";
+    ss << "\"scannedProcesses\":" << scanned << ",";
+    ss << "\"timestampMs\":" << now << ",";
+    ss << "\"files\":[";
+    for (size_t i = 0; i < files.size(); ++i) {
+        const MappedFile& f = files[i];
+        if (i > 0) ss << ",";
+        ss << "{\"path\":\"" << escape_json(f.module.path) << "\",";
+        ss << "\"dev\":\"" << std::hex << f.module.devMajor << ":" << f.module.devMinor << std::dec << "\",";
+        ss << "\"inode\":" << f.module.inode << ",";
+        ss << "\"sizeBytes\":" << f.residency.sizeBytes << ",";
+        ss << "\"cachedBytes\":" << f.residency.cachedBytes << ",";
+        ss << "\"dirtyBytes\":" << f.residency.dirtyBytes << ",";
+        ss << "\"processes\":" << f.processes << "}";
+    }
+    ss << "]";
+    ss << "}";
+
+    std::string json = ss.str();
+    std::lock_guard<std::mutex> lock(g_top_mutex);
+    g_top_json = json;
+    g_top_limit = limit;
+    g_top_at_ms = now;
+    return json;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "process_smaps.h"
+
+// How much of one file sits in the page cache.
+struct PageCacheResidency {
+    long long sizeBytes = 0;
+    long long cachedBytes = 0;
+    long long dirtyBytes = -1;   // cachestat() only; -1 under mincore()
+    long long measuredAtMs = 0;
+    bool ok = false;
+};
+
+// Results are kept per (device, inode) and re-measured only once older than
+// this; a big APK costs one mincore() per window per refresh.
+constexpr long long kPageCacheMaxAgeMs = 10000;
+constexpr size_t kPageCacheEntriesMax = 4096;
+
+// mincore() maps the file this many bytes at a time, which bounds both the
+// address space taken and the residency vector.
+constexpr size_t kMincoreWindowBytes = 64 * 1024 * 1024;
+
+// Residency of the mapped file m, opened with open_mapped_file(), from
+// cachestat() on 6.5+ kernels and mincore() over a read-only mapping
+// otherwise. Neither faults pages in, so measuring does not change the
+// answer. Only verified measurements are cached. Returns out.ok.
+bool file_page_cache(const MappedModule& m, PageCacheResidency& out);
+
+// "cachestat" or "mincore", whichever file_page_cache() is using.
+const char* page_cache_method();
+
+// Processes whose mappings the top view measures: the first page of the
+// process list in its default order, largest RSS first.
+constexpr size_t kPageCacheTopProcesses = 32;
+
+// {"method","scannedProcesses","timestampMs","files":[{"path","dev","inode",
+//  "sizeBytes","cachedBytes","dirtyBytes","processes"}]} for the module files
+// mapped by pids, most cached first. Recomputed at most every
+// kPageCacheMaxAgeMs.
+std::string page_cache_top_json(const std::vector<int>& pids, int limit);
@@ -1,6 +1,9 @@
 #include "performance_mini.h"
 #include "native_utils.h"
 #include "battery_stats.h"
+#include "proc_reader.h"
+#include "proc_meminfo.h"
+#include "proc_stat.h"
 
 #include <dirent.h>
 #include <sys/statvfs.h>
@@ -8,7 +11,7 @@
 #include <string>
 #include <vector>
 #include <ctime>
-#include <fstream>
+#include <mutex>
 
 namespace {
 
@@ -19,33 +22,21 @@ long long now_ms() {
 }
 
 // CPU mini
-static unsigned long long prev_total = 0;
-static unsigned long long prev_idle = 0;
+std::mutex g_cpu_mutex;
+CpuStatCursor g_cpu_cursor;
 
 double get_cpu_util_percent_mini() {
-    std::ifstream statFile("/proc/stat");
-    if (!statFile.is_open()) return 0.0;
-    std::string line;
-    std::getline(statFile, line);
-    statFile.close();
-    std::stringstream ss(line);
-    std::string label;
-    ss >> label;
-    unsigned long long user, nice, system, idle, iowait, irq, softirq, steal, guest, guest_nice;
-    ss >> user >> nice >> system >> idle >> iowait >> irq >> softirq >> steal >> guest >> guest_nice;
-    unsigned long long total = user + nice + system + idle + iowait + irq + softirq + steal + guest + guest_nice;
-    unsigned long long current_idle = idle + iowait;
-    double percent = 0.0;
-    if (prev_total > 0) {
-        unsigned long long delta_total = total - prev_total;
-        unsigned long long delta_idle = current_idle - prev_idle;
-        if (delta_total > 0) {
-            percent = (double(delta_total - delta_idle) / double(delta_total)) * 100.0;
-        }
+    std::shared_ptr<const CpuStatSample> sample = sample_cpu_stat();
+    std::lock_guard<std::mutex> lock(g_cpu_mutex);
+    return advance_cpu_cursor(g_cpu_cursor, *sample);
+}
+
+long read_cur_freq_khz(const std::string& base) {
+    long long cur = -1;
+    if (!cached_read_ll(StackPath{base, "scaling_cur_freq"}, cur) || cur <= 0) {
+        if (!cached_read_ll(StackPath{base, "cpuinfo_cur_freq"}, cur)) cur = -1;
     }
-    prev_total = total;
-    prev_idle = current_idle;
-    return percent;
+    return (long)cur;
 }
 
 long get_max_freq_khz_mini() {
@@ -58,8 +49,7 @@ long get_max_freq_khz_mini() {
                 std::string name = entry->d_name;
                 if (name.rfind("policy", 0) == 0) {
                     std::string base = "/sys/devices/system/cpu/cpufreq/" + name + "/";
-                    long cur = read_long_from_file(base + "scaling_cur_freq");
-                    if (cur <= 0) cur = read_long_from_file(base + "cpuinfo_cur_freq");
+                    long cur = read_cur_freq_khz(base);
                     if (cur > maxFreq) maxFreq = cur;
                 }
             }
@@ -78,8 +68,7 @@ long get_max_freq_khz_mini() {
                 std::string idx = name.substr(3);
                 if (idx.empty() || idx.find_first_not_of("0123456789") != std::string::npos) continue;
                 std::string base = "/sys/devices/system/cpu/" + name + "/cpufreq/";
-                long cur = read_long_from_file(base + "scaling_cur_freq");
-                if (cur <= 0) cur = read_long_from_file(base + "cpuinfo_cur_freq");
+                long cur = read_cur_freq_khz(base);
                 if (cur > maxFreq) maxFreq = cur;
             }
         }
@@ -90,27 +79,9 @@ long get_max_freq_khz_mini() {
 
 // Memory mini
 void read_meminfo_mini(long& usedBytes, long& totalBytes) {
-    std::ifstream memFile("/proc/meminfo");
-    long totalKb = 0;
-    long availKb = 0;
-    if (memFile.is_open()) {
-        std::string line;
-        while (std::getline(memFile, line)) {
-            std::stringstream ss(line);
-            std::string key;
-            long value = 0;
-            std::string unit;
-            ss >> key >> value >> unit;
-            if (key == "MemTotal:") {
-                totalKb = value;
-            } else if (key == "MemAvailable:") {
-                availKb = value;
-            }
-            if (totalKb > 0 && availKb > 0) break;
-        }
-    }
-    totalBytes = totalKb * 1024L;
-    long availableBytes = availKb * 1024L;
+    std::shared_ptr<const MemSample> sample = sample_memory();
+    totalBytes = (long)(sample->mem.memTotal * 1024L);
+    long availableBytes = (long)(sample->mem.memAvailable * 1024L);
     long used = totalBytes - availableBytes;
     if (used < 0) used = 0;
     usedBytes = used;
@@ -151,12 +122,12 @@ std::string basename_path(const std::string& path) {
 
 bool read_block_stat_mini(const std::string& dev, DiskSampleMini& out) {
     std::string statPath = "/sys/block/" + dev + "/stat";
-    std::string content = read_file_string(statPath);
-    if (content.empty()) return false;
-    std::stringstream ss(content);
+    char buf[256];
+    if (cached_read_into(statPath, buf, sizeof(buf)) <= 0) return false;
+    std::string_view content(buf);
     long long vals[11];
     for (int i = 0; i < 11; ++i) {
-        if (!(ss >> vals[i])) return false;
+        if (!parse_ll(content, vals[i])) return false;
     }
     out.sectorsRead = vals[2];
     out.sectorsWritten = vals[6];
@@ -210,12 +181,12 @@ struct NetCountersMini {
 };
 
 bool iface_is_up(const std::string& iface) {
-    std::string oper = read_first_line("/sys/class/net/" + iface + "/operstate");
+    std::string oper = cached_read_first_line(StackPath{"/sys/class/net/", iface, "/operstate"});
     if (!oper.empty()) {
         std::string lower = to_lower(trim(oper));
         if (lower == "up") return true;
     }
-    std::string carrier = read_first_line("/sys/class/net/" + iface + "/carrier");
+    std::string carrier = cached_read_first_line(StackPath{"/sys/class/net/", iface, "/carrier"});
     if (!carrier.empty()) {
         return trim(carrier) == "1";
     }
@@ -223,43 +194,36 @@ bool iface_is_up(const std::string& iface) {
 }
 
 std::vector<std::string> list_ifaces() {
-    std::string names = read_file_string("/proc/net/dev");
+    std::string_view content = cached_read_view("/proc/net/dev");
     std::vector<std::string> out;
-    if (names.empty()) return out;
-    std::stringstream ss(names);
-    std::string line;
     int lineNo = 0;
-    while (std::getline(ss, line)) {
+    while (!content.empty()) {
+        std::string_view line = next_line(content);
         lineNo++;
         if (lineNo <= 2) continue;
-        auto colon = line.find(':');
-        if (colon == std::string::npos) continue;
-        std::string name = trim(line.substr(0, colon));
-        if (!name.empty()) out.push_back(name);
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos) continue;
+        std::string_view name = trim_view(line.substr(0, colon));
+        if (!name.empty()) out.emplace_back(name);
     }
     return out;
 }
 
 bool read_iface_counters(const std::string& iface, NetCountersMini& out) {
-    std::string data = read_file_string("/proc/net/dev");
-    if (data.empty()) return false;
-    std::stringstream ss(data);
-    std::string line;
-    while (std::getline(ss, line)) {
-        auto colon = line.find(':');
-        if (colon == std::string::npos) continue;
-        std::string name = trim(line.substr(0, colon));
-        if (name != iface) continue;
-        std::stringstream ls(line.substr(colon + 1));
-        long long rxBytes = 0, rxPackets = 0, rxErr = 0, rxDrop = 0, rxFifo = 0, rxFrame = 0, rxCompressed = 0, rxMulticast = 0;
-        long long txBytes = 0, txPackets = 0, txErr = 0, txDrop = 0, txFifo = 0, txColls = 0, txCarrier = 0, txCompressed = 0;
-        if (!(ls >> rxBytes >> rxPackets >> rxErr >> rxDrop >> rxFifo >> rxFrame >> rxCompressed >> rxMulticast
-                 >> txBytes >> txPackets >> txErr >> txDrop >> txFifo >> txColls >> txCarrier >> txCompressed)) {
-            return false;
+    std::string_view content = cached_read_view("/proc/net/dev");
+    while (!content.empty()) {
+        std::string_view line = next_line(content);
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos) continue;
+        if (trim_view(line.substr(0, colon)) != iface) continue;
+        std::string_view rest = line.substr(colon + 1);
+        long long vals[16];
+        for (int i = 0; i < 16; ++i) {
+            if (!parse_ll(rest, vals[i])) return false;
         }
         out.iface = iface;
-        out.rxBytes = rxBytes;
-        out.txBytes = txBytes;
+        out.rxBytes = vals[0];
+        out.txBytes = vals[8];
         return true;
     }
     return false;
@@ -300,12 +264,9 @@ NetCountersMini get_net_counters_mini() {
 
 // GPU mini
 int read_gpu_busy_percent() {
-    std::string raw = read_file_string("/sys/class/kgsl/kgsl-3d0/gpu_busy_percentage");
-    if (raw.empty()) return -1;
-    std::stringstream ss(raw);
-    int v = -1;
-    ss >> v;
-    return v;
+    long long v = -1;
+    if (!cached_read_ll("/sys/class/kgsl/kgsl-3d0/gpu_busy_percentage", v)) return -1;
+    return (int)v;
 }
 
 } // namespace
@@ -0,0 +1,105 @@
+#include "pid_table.h"
+#include "proc_reader.h"
+
+namespace {
+
+constexpr size_t kMinCapacity = 256;
+constexpr long long kDefaultPidMax = 32768;
+
+size_t next_pow2(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+bool is_live(const PidSlot& slot, unsigned long long gen) {
+    return slot.pid != 0 && slot.stamp + 1 >= gen;
+}
+
+unsigned log2_pow2(size_t n) {
+    unsigned bits = 0;
+    while (((size_t)1 << bits) < n) ++bits;
+    return bits;
+}
+
+void reset_slot(PidSlot& slot, int pid, unsigned long long gen) {
+    slot = PidSlot();
+    slot.pid = pid;
+    slot.stamp = gen;
+}
+
+} // namespace
+
+PidTable::PidTable() {
+    long long pidMax = kDefaultPidMax;
+    if (!read_ll_file("/proc/sys/kernel/pid_max", pidMax) || pidMax <= 0) pidMax = kDefaultPidMax;
+    maxCapacity_ = next_pow2((size_t)pidMax) * 2;
+    slots_.resize(kMinCapacity);
+    shift_ = 32 - log2_pow2(kMinCapacity);
+}
+
+size_t PidTable::home(int pid) const {
+    // Fibonacci hashing: the top log2(capacity) bits of pid * 2^32/phi spread
+    // the dense, sequential PID range evenly.
+    return (size_t)(((unsigned)pid * 2654435769u) >> shift_);
+}
+
+PidSlot& PidTable::touch(int pid, unsigned long long gen, bool& prevSeen) {
+    if ((used_ + 1) * 2 > slots_.size()) {
+        size_t live = 0;
+        for (const PidSlot& slot : slots_) {
+            if (is_live(slot, gen)) ++live;
+        }
+        size_t capacity = next_pow2((live + 1) * 4);
+        if (capacity < kMinCapacity) capacity = kMinCapacity;
+        if (capacity > maxCapacity_) capacity = maxCapacity_;
+        rebuild(capacity, gen);
+    }
+
+    const size_t mask = slots_.size() - 1;
+    size_t reuse = slots_.size();
+    size_t i = home(pid);
+    while (slots_[i].pid != 0) {
+        PidSlot& slot = slots_[i];
+        if (slot.pid == pid) {
+            prevSeen = slot.stamp + 1 == gen;
+            if (!prevSeen && slot.stamp != gen) reset_slot(slot, pid, gen);
+            slot.stamp = gen;
+            return slot;
+        }
+        if (reuse == slots_.size() && !is_live(slot, gen)) reuse = i;
+        i = (i + 1) & mask;
+    }
+
+    prevSeen = false;
+    if (reuse == slots_.size()) {
+        reuse = i;
+        ++used_;
+    }
+    reset_slot(slots_[reuse], pid, gen);
+    return slots_[reuse];
+}
+
+PidSlot* PidTable::find(int pid, unsigned long long gen) {
+    const size_t mask = slots_.size() - 1;
+    for (size_t i = home(pid); slots_[i].pid != 0; i = (i + 1) & mask) {
+        if (slots_[i].pid == pid) return slots_[i].stamp == gen ? &slots_[i] : nullptr;
+    }
+    return nullptr;
+}
+
+void PidTable::rebuild(size_t capacity, unsigned long long gen) {
+    std::vector<PidSlot> old;
+    old.swap(slots_);
+    slots_.resize(capacity);
+    shift_ = 32 - log2_pow2(capacity);
+    used_ = 0;
+    const size_t mask = capacity - 1;
+    for (PidSlot& slot : old) {
+        if (!is_live(slot, gen)) continue;
+        size_t i = home(slot.pid);
+        while (slots_[i].pid != 0) i = (i + 1) & mask;
+        slots_[i] = std::move(slot);
+        ++used_;
+    }
+}
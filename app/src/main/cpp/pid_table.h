@@ -0,0 +1,70 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// Rolling per-PID state carried from one process scan to the next.
+struct PidSlot {
+    int pid = 0;                       // 0: never used
+    unsigned long long stamp = 0;      // scan generation that last saw this PID
+    unsigned long long starttime = 0;  // stat field 22, tells reused PIDs apart
+    unsigned long long procTicks = 0;  // utime + stime
+    unsigned long long sysTicks = 0;   // total system ticks at the same scan
+    unsigned long long minflt = 0;
+    unsigned long long majflt = 0;
+
+    // smaps_rollup baseline: RSS and minflt + majflt when it was last read.
+    long pssReadRamBytes = 0;
+    unsigned long long pssReadFaults = 0;
+    long long pssReadAtMs = 0;         // 0: never read
+    long long pssFailedAtMs = 0;       // last failed read, 0: none since
+
+    // Values last sent to delta clients and the generation that sent them.
+    std::shared_ptr<const std::string> name;
+    long ramBytes = 0;
+    double cpu = 0.0;
+    long nice = 0;
+    long pssBytes = -1;                // -1 until smaps_rollup has been read
+    long ussBytes = -1;
+    long swapPssBytes = -1;
+    unsigned long long changedGen = 0;
+};
+
+// Open-addressing (linear probing) table of PidSlot in one contiguous array.
+//
+// Liveness comes from generation stamps instead of erasure: a slot stamped
+// in the current or previous scan is live, anything older is dead and is
+// overwritten by the next insert that probes past it. Dead slots are only
+// dropped for good when the table is rebuilt on growth, so no per-scan
+// sweep is needed. Capacity never exceeds twice /proc/sys/kernel/pid_max.
+class PidTable {
+public:
+    PidTable();
+
+    // Returns the slot for pid and stamps it with gen. prevSeen is true when
+    // the slot carries state from scan gen - 1; otherwise the slot is reset.
+    PidSlot& touch(int pid, unsigned long long gen, bool& prevSeen);
+
+    // The slot for pid if it was stamped with gen, without stamping it.
+    PidSlot* find(int pid, unsigned long long gen);
+
+    // Calls fn(slot) for every slot last stamped with gen.
+    template <typename Fn>
+    void for_each_stamped(unsigned long long gen, Fn&& fn) const {
+        for (const PidSlot& slot : slots_) {
+            if (slot.pid != 0 && slot.stamp == gen) fn(slot);
+        }
+    }
+
+    size_t capacity() const { return slots_.size(); }
+
+private:
+    void rebuild(size_t capacity, unsigned long long gen);
+    size_t home(int pid) const;
+
+    std::vector<PidSlot> slots_;
+    size_t used_ = 0;  // slots with pid != 0, live or dead
+    size_t maxCapacity_;
+    unsigned shift_;  // 32 - log2(capacity), for home()
+};
@@ -0,0 +1,217 @@
+#include "proc_meminfo.h"
+#include "proc_reader.h"
+
+#include <ctime>
+#include <mutex>
+
+namespace {
+
+std::mutex g_mem_mutex;
+std::shared_ptr<const MemSample> g_mem_latest;
+
+long long now_ms() {
+    struct timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000LL;
+}
+
+bool has_prefix(std::string_view s, std::string_view prefix) {
+    return s.size() >= prefix.size() && s.compare(0, prefix.size(), prefix) == 0;
+}
+
+// Dispatches on the first byte so each line costs at most a handful of
+// compares instead of one per tracked key.
+unsigned long long* meminfo_slot(MemInfo& m, std::string_view key) {
+    switch (key[0]) {
+        case 'A':
+            if (key == "Active") return &m.active;
+            if (key == "Active(anon)") return &m.activeAnon;
+            if (key == "Active(file)") return &m.activeFile;
+            if (key == "AnonPages") return &m.anonPages;
+            break;
+        case 'B':
+            if (key == "Buffers") return &m.buffers;
+            break;
+        case 'C':
+            if (key == "Cached") return &m.cached;
+            if (key == "CommitLimit") return &m.commitLimit;
+            if (key == "Committed_AS") return &m.committedAs;
+            if (key == "Compressed") return &m.compressed;
+            break;
+        case 'D':
+            if (key == "Dirty") return &m.dirty;
+            break;
+        case 'I':
+            if (key == "Inactive") return &m.inactive;
+            if (key == "Inactive(anon)") return &m.inactiveAnon;
+            if (key == "Inactive(file)") return &m.inactiveFile;
+            break;
+        case 'K':
+            if (key == "KReclaimable") return &m.kReclaimable;
+            if (key == "KernelStack") return &m.kernelStack;
+            break;
+        case 'M':
+            if (key == "MemTotal") return &m.memTotal;
+            if (key == "MemFree") return &m.memFree;
+            if (key == "MemAvailable") return &m.memAvailable;
+            if (key == "Mapped") return &m.mapped;
+            if (key == "Mlocked") return &m.mlocked;
+            break;
+        case 'P':
+            if (key == "PageTables") return &m.pageTables;
+            break;
+        case 'S':
+            if (key == "SwapCached") return &m.swapCached;
+            if (key == "SwapTotal") return &m.swapTotal;
+            if (key == "SwapFree") return &m.swapFree;
+            if (key == "Shmem") return &m.shmem;
+            if (key == "Slab") return &m.slab;
+            if (key == "SReclaimable") return &m.sReclaimable;
+            if (key == "SUnreclaim") return &m.sUnreclaim;
+            break;
+        case 'U':
+            if (key == "Unevictable") return &m.unevictable;
+            break;
+        case 'V':
+            if (key == "VmallocUsed") return &m.vmallocUsed;
+            break;
+        case 'W':
+            if (key == "Writeback") return &m.writeback;
+            break;
+        case 'Z':
+            if (key == "Zswap") return &m.zswap;
+            if (key == "Zswapped") return &m.zswapped;
+            break;
+        default:
+            break;
+    }
+    return nullptr;
+}
+
+// Returns the field a vmstat counter adds into. Several names can map to
+// the same field across kernel versions, so callers accumulate.
+unsigned long long* vmstat_slot(VmStat& v, std::string_view key) {
+    switch (key[0]) {
+        case 'a':
+            // "allocstall" before 4.10, "allocstall_<zone>" after.
+            if (has_prefix(key, "allocstall")) return &v.allocstall;
+            break;
+        case 'o':
+            if (key == "oom_kill") return &v.oomKill;
+            break;
+        case 'p':
+            if (key.size() < 3) break;
+            if (key[1] == 's') {
+                if (key == "pswpin") return &v.pswpin;
+                if (key == "pswpout") return &v.pswpout;
+                break;
+            }
+            if (key == "pgpgin") return &v.pgpgin;
+            if (key == "pgpgout") return &v.pgpgout;
+            if (key == "pgfault") return &v.pgfault;
+            if (key == "pgmajfault") return &v.pgmajfault;
+            if (has_prefix(key, "pgscan_")) {
+                if (key == "pgscan_direct_throttle") break;
+                if (has_prefix(key, "pgscan_kswapd") || has_prefix(key, "pgscan_khugepaged") ||
+                    key == "pgscan_proactive") {
+                    return &v.pgscanKswapd;
+                }
+                if (has_prefix(key, "pgscan_direct")) return &v.pgscanDirect;
+                break;  // pgscan_anon/pgscan_file double count the above
+            }
+            if (has_prefix(key, "pgsteal_")) {
+                if (has_prefix(key, "pgsteal_kswapd") || has_prefix(key, "pgsteal_khugepaged") ||
+                    key == "pgsteal_proactive") {
+                    return &v.pgstealKswapd;
+                }
+                if (has_prefix(key, "pgsteal_direct")) return &v.pgstealDirect;
+                break;
+            }
+            break;
+        case 'w':
+            // "workingset_refault" before 5.9, "_anon" and "_file" after.
+            if (key == "workingset_refault" || key == "workingset_refault_anon" || key == "workingset_refault_file") {
+                return &v.workingsetRefault;
+            }
+            break;
+        default:
+            break;
+    }
+    return nullptr;
+}
+
+// "Key:   1234 kB"
+void parse_meminfo(std::string_view content, MemInfo& out) {
+    while (!content.empty()) {
+        std::string_view line = next_line(content);
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos || colon == 0) continue;
+        unsigned long long* slot = meminfo_slot(out, line.substr(0, colon));
+        if (!slot) continue;
+        std::string_view rest = line.substr(colon + 1);
+        parse_ull(rest, *slot);
+    }
+}
+
+// "key 1234"
+void parse_vmstat(std::string_view content, VmStat& out) {
+    while (!content.empty()) {
+        std::string_view line = next_line(content);
+        std::string_view key = next_token(line);
+        if (key.empty()) continue;
+        unsigned long long* slot = vmstat_slot(out, key);
+        if (!slot) continue;
+        unsigned long long value = 0;
+        if (parse_ull(line, value)) *slot += value;
+    }
+}
+
+double per_sec(unsigned long long prev, unsigned long long cur, double seconds) {
+    if (cur < prev) return 0.0;
+    return double(cur - prev) / seconds;
+}
+
+} // namespace
+
+std::shared_ptr<const MemSample> sample_memory() {
+    std::lock_guard<std::mutex> lock(g_mem_mutex);
+    long long now = now_ms();
+    if (g_mem_latest && now - g_mem_latest->takenAtMs < kMemSampleCoalesceMs) return g_mem_latest;
+
+    auto sample = std::make_shared<MemSample>();
+    sample->seq = g_mem_latest ? g_mem_latest->seq + 1 : 1;
+    sample->takenAtMs = now;
+    // Both views share this thread's scratch buffer, so finish one file
+    // before reading the next.
+    parse_meminfo(cached_read_view("/proc/meminfo"), sample->mem);
+    parse_vmstat(cached_read_view("/proc/vmstat"), sample->vm);
+    g_mem_latest = sample;
+    return g_mem_latest;
+}
+
+const MemRates& advance_mem_rates(MemRateCursor& cursor, const MemSample& sample) {
+    if (cursor.seq == sample.seq) return cursor.rates;
+    MemRates rates;
+    long long elapsedMs = sample.takenAtMs - cursor.takenAtMs;
+    if (cursor.seq != 0 && elapsedMs > 0) {
+        double s = elapsedMs / 1000.0;
+        const VmStat& a = cursor.vm;
+        const VmStat& b = sample.vm;
+        rates.pgpgin = per_sec(a.pgpgin, b.pgpgin, s);
+        rates.pgpgout = per_sec(a.pgpgout, b.pgpgout, s);
+        rates.pswpin = per_sec(a.pswpin, b.pswpin, s);
+        rates.pswpout = per_sec(a.pswpout, b.pswpout, s);
+        rates.pgfault = per_sec(a.pgfault, b.pgfault, s);
+        rates.pgmajfault = per_sec(a.pgmajfault, b.pgmajfault, s);
+        rates.pgscan = per_sec(a.pgscanKswapd + a.pgscanDirect, b.pgscanKswapd + b.pgscanDirect, s);
+        rates.pgsteal = per_sec(a.pgstealKswapd + a.pgstealDirect, b.pgstealKswapd + b.pgstealDirect, s);
+        rates.pgscanDirect = per_sec(a.pgscanDirect, b.pgscanDirect, s);
+        rates.workingsetRefault = per_sec(a.workingsetRefault, b.workingsetRefault, s);
+        rates.allocstall = per_sec(a.allocstall, b.allocstall, s);
+    }
+    cursor.seq = sample.seq;
+    cursor.takenAtMs = sample.takenAtMs;
+    cursor.vm = sample.vm;
+    cursor.rates = rates;
+    return cursor.rates;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <memory>
+
+// /proc/meminfo, in kB. Lines the kernel does not have stay 0.
+struct MemInfo {
+    unsigned long long memTotal = 0;
+    unsigned long long memFree = 0;
+    unsigned long long memAvailable = 0;
+    unsigned long long buffers = 0;
+    unsigned long long cached = 0;
+    unsigned long long swapCached = 0;
+    unsigned long long active = 0;
+    unsigned long long inactive = 0;
+    unsigned long long activeAnon = 0;
+    unsigned long long inactiveAnon = 0;
+    unsigned long long activeFile = 0;
+    unsigned long long inactiveFile = 0;
+    unsigned long long unevictable = 0;
+    unsigned long long mlocked = 0;
+    unsigned long long swapTotal = 0;
+    unsigned long long swapFree = 0;
+    unsigned long long dirty = 0;
+    unsigned long long writeback = 0;
+    unsigned long long anonPages = 0;
+    unsigned long long mapped = 0;
+    unsigned long long shmem = 0;
+    unsigned long long kReclaimable = 0;
+    unsigned long long slab = 0;
+    unsigned long long sReclaimable = 0;
+    unsigned long long sUnreclaim = 0;
+    unsigned long long kernelStack = 0;
+    unsigned long long pageTables = 0;
+    unsigned long long commitLimit = 0;
+    unsigned long long committedAs = 0;
+    unsigned long long vmallocUsed = 0;
+    unsigned long long zswap = 0;
+    unsigned long long zswapped = 0;
+    unsigned long long compressed = 0;  // vendor kernels only
+};
+
+// Cumulative /proc/vmstat event counters. Per-zone and per-type variants
+// (pgscan_kswapd_normal, allocstall_movable, workingset_refault_file, ...)
+// are summed into one field.
+struct VmStat {
+    unsigned long long pgpgin = 0;
+    unsigned long long pgpgout = 0;
+    unsigned long long pswpin = 0;
+    unsigned long long pswpout = 0;
+    unsigned long long pgfault = 0;
+    unsigned long long pgmajfault = 0;
+    unsigned long long pgscanKswapd = 0;   // every background reclaimer
+    unsigned long long pgscanDirect = 0;
+    unsigned long long pgstealKswapd = 0;
+    unsigned long long pgstealDirect = 0;
+    unsigned long long workingsetRefault = 0;
+    unsigned long long allocstall = 0;
+    unsigned long long oomKill = 0;
+};
+
+// One pass over /proc/meminfo and /proc/vmstat.
+struct MemSample {
+    unsigned long long seq = 0;
+    long long takenAtMs = 0;
+    MemInfo mem;
+    VmStat vm;
+};
+
+// Reads closer together than this share one sample.
+constexpr long long kMemSampleCoalesceMs = 50;
+
+// Latest sample, re-read only when the cached one is older than
+// kMemSampleCoalesceMs. Never null; unreadable files yield zeroes.
+std::shared_ptr<const MemSample> sample_memory();
+
+// Per-second vmstat rates between two samples.
+struct MemRates {
+    double pgpgin = 0.0;
+    double pgpgout = 0.0;
+    double pswpin = 0.0;
+    double pswpout = 0.0;
+    double pgfault = 0.0;
+    double pgmajfault = 0.0;
+    double pgscan = 0.0;
+    double pgsteal = 0.0;
+    double pgscanDirect = 0.0;
+    double workingsetRefault = 0.0;
+    double allocstall = 0.0;
+};
+
+// A consumer's own baseline, like CpuStatCursor.
+struct MemRateCursor {
+    unsigned long long seq = 0;
+    long long takenAtMs = 0;
+    VmStat vm;
+    MemRates rates;
+};
+
+// Rates between the cursor and sample, then moves the cursor to sample.
+// All zero on the first call; the previous rates when sample is the one the
+// cursor already holds. A counter that went backwards rates 0.
+const MemRates& advance_mem_rates(MemRateCursor& cursor, const MemSample& sample);
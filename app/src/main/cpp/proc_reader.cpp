@@ -0,0 +1,278 @@
+#include "proc_reader.h"
+
+#include <charconv>
+#include <cerrno>
+#include <ctime>
+#include <fcntl.h>
+#include <memory>
+#include <mutex>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace {
+
+bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+void skip_blanks(std::string_view& s) {
+    size_t i = 0;
+    while (i < s.size() && is_blank(s[i])) ++i;
+    s.remove_prefix(i);
+}
+
+long long monotonic_ms() {
+    struct timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000LL;
+}
+
+bool is_gone_error(int err) {
+    return err == ENODEV || err == ESTALE || err == ENOENT || err == ESRCH || err == EBADF;
+}
+
+// Closed when the last holder lets go, so a reader can pread outside the
+// cache lock while the entry is evicted or invalidated under it.
+struct FdHandle {
+    int fd;
+    explicit FdHandle(int f) : fd(f) {}
+    ~FdHandle() { close(fd); }
+    FdHandle(const FdHandle&) = delete;
+    FdHandle& operator=(const FdHandle&) = delete;
+};
+
+struct CachedFd {
+    std::string path;  // owns the characters of the entry's map key
+    std::shared_ptr<FdHandle> handle;
+    unsigned long long lastUse = 0;
+    long long retryAtMs = 0;
+};
+
+std::mutex g_fd_cache_mutex;
+// Keyed by a view of CachedFd::path so lookups by std::string_view need no
+// temporary string.
+std::unordered_map<std::string_view, std::unique_ptr<CachedFd>> g_fd_cache;
+unsigned long long g_fd_cache_clock = 0;
+
+void evict_lru_locked() {
+    auto victim = g_fd_cache.end();
+    for (auto it = g_fd_cache.begin(); it != g_fd_cache.end(); ++it) {
+        if (victim == g_fd_cache.end() || it->second->lastUse < victim->second->lastUse) {
+            victim = it;
+        }
+    }
+    if (victim == g_fd_cache.end()) return;
+    g_fd_cache.erase(victim);
+}
+
+// seq_files (/proc/vmstat, /proc/net/dev, /proc/swaps) hand back at most a
+// page per read, stopping before the record that would not fit. A read that
+// leaves more than kSeqRecordSlack of its page unused is therefore the end
+// of the file, so anything under a page (every sysfs attribute) costs one
+// syscall and only multi-page files read on.
+constexpr size_t kSeqRecordSlack = 512;
+
+size_t page_size() {
+    static const size_t size = sysconf(_SC_PAGESIZE) > 0 ? (size_t)sysconf(_SC_PAGESIZE) : 4096;
+    return size;
+}
+
+ssize_t pread_all(int fd, char* buf, size_t cap) {
+    size_t total = 0;
+    while (total < cap - 1) {
+        size_t want = cap - 1 - total;
+        ssize_t n = pread(fd, buf + total, want, (off_t)total);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        total += (size_t)n;
+        if (!seq_read_continues((size_t)n, want)) break;
+    }
+    buf[total] = '\0';
+    return (ssize_t)total;
+}
+
+} // namespace
+
+bool seq_read_continues(size_t got, size_t wanted) {
+    return got > 0 && got < wanted && got + kSeqRecordSlack >= page_size();
+}
+
+ssize_t read_file_into(const char* path, char* buf, size_t cap) {
+    if (cap == 0) return -1;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    ssize_t n = pread_all(fd, buf, cap);
+    close(fd);
+    return n;
+}
+
+std::string_view read_file_view(const char* path) {
+    thread_local char scratch[kProcScratchSize];
+    ssize_t n = read_file_into(path, scratch, sizeof(scratch));
+    if (n <= 0) return {};
+    return std::string_view(scratch, (size_t)n);
+}
+
+bool read_file_to_string(const char* path, std::string& out) {
+    out.clear();
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    char chunk[4096];
+    while (true) {
+        ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            close(fd);
+            return false;
+        }
+        if (n == 0) break;
+        out.append(chunk, (size_t)n);
+    }
+    close(fd);
+    return true;
+}
+
+bool read_ll_file(const char* path, long long& out) {
+    char buf[64];
+    ssize_t n = read_file_into(path, buf, sizeof(buf));
+    if (n <= 0) return false;
+    std::string_view s(buf, (size_t)n);
+    return parse_ll(s, out);
+}
+
+std::string_view trim_view(std::string_view s) {
+    skip_blanks(s);
+    while (!s.empty() && is_blank(s.back())) s.remove_suffix(1);
+    return s;
+}
+
+std::string_view next_line(std::string_view& s) {
+    size_t nl = s.find('\n');
+    std::string_view line = s.substr(0, nl);
+    s.remove_prefix(nl == std::string_view::npos ? s.size() : nl + 1);
+    return line;
+}
+
+std::string_view next_token(std::string_view& s) {
+    skip_blanks(s);
+    size_t i = 0;
+    while (i < s.size() && !is_blank(s[i])) ++i;
+    std::string_view tok = s.substr(0, i);
+    s.remove_prefix(i);
+    return tok;
+}
+
+bool parse_ll(std::string_view& s, long long& out) {
+    skip_blanks(s);
+    // from_chars rejects a leading '+', which sysfs never emits anyway.
+    auto res = std::from_chars(s.data(), s.data() + s.size(), out);
+    if (res.ec != std::errc()) return false;
+    s.remove_prefix((size_t)(res.ptr - s.data()));
+    return true;
+}
+
+bool parse_ull(std::string_view& s, unsigned long long& out) {
+    skip_blanks(s);
+    auto res = std::from_chars(s.data(), s.data() + s.size(), out);
+    if (res.ec != std::errc()) return false;
+    s.remove_prefix((size_t)(res.ptr - s.data()));
+    return true;
+}
+
+bool parse_keyed_ll(std::string_view line, std::string_view key, long long& out) {
+    if (line.size() < key.size() || line.compare(0, key.size(), key) != 0) return false;
+    line.remove_prefix(key.size());
+    return parse_ll(line, out);
+}
+
+namespace {
+
+// The descriptor for path, opened on first use. Null while path is in its
+// retry window after a failed open.
+std::shared_ptr<FdHandle> acquire_fd(std::string_view path) {
+    std::lock_guard<std::mutex> lock(g_fd_cache_mutex);
+    auto it = g_fd_cache.find(path);
+    if (it == g_fd_cache.end()) {
+        if (g_fd_cache.size() >= kFdCacheMaxEntries) evict_lru_locked();
+        auto entry = std::make_unique<CachedFd>();
+        entry->path = std::string(path);
+        std::string_view key = entry->path;
+        it = g_fd_cache.emplace(key, std::move(entry)).first;
+    }
+    CachedFd& entry = *it->second;
+    entry.lastUse = ++g_fd_cache_clock;
+    if (!entry.handle) {
+        long long now = monotonic_ms();
+        if (entry.retryAtMs > now) return nullptr;
+        int fd = open(entry.path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            entry.retryAtMs = now + kFdCacheRetryMs;
+            return nullptr;
+        }
+        entry.handle = std::make_shared<FdHandle>(fd);
+    }
+    return entry.handle;
+}
+
+// Forgets handle unless another reader already replaced it.
+void drop_fd(std::string_view path, const std::shared_ptr<FdHandle>& handle) {
+    std::lock_guard<std::mutex> lock(g_fd_cache_mutex);
+    auto it = g_fd_cache.find(path);
+    if (it != g_fd_cache.end() && it->second->handle == handle) it->second->handle.reset();
+}
+
+} // namespace
+
+ssize_t cached_read_into(std::string_view path, char* buf, size_t cap) {
+    if (cap == 0 || path.empty()) return -1;
+    // One retry covers a descriptor that went stale since the last tick
+    // (a thermal zone re-registered, a PID that exited and was reused).
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        std::shared_ptr<FdHandle> handle = acquire_fd(path);
+        if (!handle) return -1;
+        // Outside the lock: cached reads from different threads do not wait
+        // on each other's syscalls.
+        ssize_t n = pread_all(handle->fd, buf, cap);
+        if (n >= 0) return n;
+        int err = errno;
+        drop_fd(path, handle);
+        if (!is_gone_error(err)) return -1;
+    }
+    return -1;
+}
+
+std::string_view cached_read_view(std::string_view path) {
+    thread_local char scratch[kProcScratchSize];
+    ssize_t n = cached_read_into(path, scratch, sizeof(scratch));
+    if (n <= 0) return {};
+    return std::string_view(scratch, (size_t)n);
+}
+
+bool cached_read_ll(std::string_view path, long long& out) {
+    char buf[64];
+    ssize_t n = cached_read_into(path, buf, sizeof(buf));
+    if (n <= 0) return false;
+    std::string_view s(buf, (size_t)n);
+    return parse_ll(s, out);
+}
+
+std::string cached_read_first_line(std::string_view path) {
+    char buf[256];
+    ssize_t n = cached_read_into(path, buf, sizeof(buf));
+    if (n <= 0) return "";
+    std::string_view s(buf, (size_t)n);
+    return std::string(next_line(s));
+}
+
+void fd_cache_invalidate(std::string_view prefix) {
+    std::lock_guard<std::mutex> lock(g_fd_cache_mutex);
+    for (auto it = g_fd_cache.begin(); it != g_fd_cache.end(); ) {
+        if (it->first.compare(0, prefix.size(), prefix) == 0) {
+            it = g_fd_cache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+
+// Allocation-free readers for small procfs/sysfs files.
+//
+// Files are read with open()+read() into either a caller buffer or a
+// per-thread scratch buffer, and values are extracted with std::from_chars.
+// None of the scalar helpers below touch the heap.
+
+constexpr size_t kProcScratchSize = 16384;
+
+// Whether a read that returned got of the wanted bytes may be one page of a
+// longer seq_file, so the file should be read on from where it stopped.
+// Shorter reads are the end of the file; every reader here, including the
+// io_uring batch, stops on the same rule.
+bool seq_read_continues(size_t got, size_t wanted);
+
+// Reads up to cap - 1 bytes of path into buf and NUL-terminates it.
+// Returns the number of bytes read, or -1 if the file cannot be opened/read.
+ssize_t read_file_into(const char* path, char* buf, size_t cap);
+
+// Reads path into this thread's scratch buffer. The view stays valid until the
+// next read_file_view() call on the same thread. Files larger than
+// kProcScratchSize are truncated. Returns an empty view on failure.
+std::string_view read_file_view(const char* path);
+
+// Whole-file read into a std::string, for files of unbounded size
+// (/proc/<pid>/maps, /proc/mounts, ...).
+bool read_file_to_string(const char* path, std::string& out);
+
+// Reads the first integer in a scalar file such as a sysfs attribute.
+bool read_ll_file(const char* path, long long& out);
+
+std::string_view trim_view(std::string_view s);
+
+// Splits off the next line (without the '\n') and advances s past it.
+std::string_view next_line(std::string_view& s);
+
+// Skips leading blanks, returns the next blank-delimited token and advances s.
+std::string_view next_token(std::string_view& s);
+
+// Skips leading blanks and parses a decimal integer, advancing s past it.
+bool parse_ll(std::string_view& s, long long& out);
+bool parse_ull(std::string_view& s, unsigned long long& out);
+
+// Parses the value of a "Key:   1234 kB" style line (meminfo, status).
+// Returns false if line does not start with key.
+bool parse_keyed_ll(std::string_view line, std::string_view key, long long& out);
+
+// Process-wide cache of open descriptors for files that are polled on every
+// snapshot. Reads go through pread(fd, buf, n, 0), so a cached counter costs
+// one syscall; only seq_files longer than a page take more. The pread runs
+// outside the cache lock. Descriptors are dropped when the kernel reports the file gone
+// (ENODEV, ESTALE, ENOENT, ESRCH) and the cache holds at most
+// kFdCacheMaxEntries descriptors, evicting the least recently used.
+// Paths that fail to open are remembered for kFdCacheRetryMs before retrying.
+constexpr size_t kFdCacheMaxEntries = 96;
+constexpr long long kFdCacheRetryMs = 5000;
+
+// Paths are looked up as views, so a literal or a StackPath costs no heap
+// allocation once its descriptor is cached.
+ssize_t cached_read_into(std::string_view path, char* buf, size_t cap);
+std::string_view cached_read_view(std::string_view path);
+bool cached_read_ll(std::string_view path, long long& out);
+std::string cached_read_first_line(std::string_view path);
+
+// Closes every cached descriptor whose path starts with prefix.
+void fd_cache_invalidate(std::string_view prefix);
+
+// A path joined on the stack, for per-object files read every tick
+// ("/sys/class/net/" + iface + "/operstate") without building a std::string.
+// Longer than kStackPathMax it is empty, which no read accepts.
+constexpr size_t kStackPathMax = 256;
+
+class StackPath {
+public:
+    StackPath(std::initializer_list<std::string_view> parts) {
+        for (std::string_view part : parts) {
+            if (len_ + part.size() >= kStackPathMax) {
+                len_ = 0;
+                break;
+            }
+            part.copy(buf_ + len_, part.size());
+            len_ += part.size();
+        }
+        buf_[len_] = '\0';
+    }
+    operator std::string_view() const { return std::string_view(buf_, len_); }
+    const char* c_str() const { return buf_; }
+
+private:
+    char buf_[kStackPathMax];
+    size_t len_ = 0;
+};
@@ -0,0 +1,101 @@
+#include "proc_stat.h"
+#include "proc_reader.h"
+
+#include <ctime>
+#include <mutex>
+
+namespace {
+
+std::mutex g_stat_mutex;
+std::shared_ptr<const CpuStatSample> g_stat_latest;
+
+long long now_ms() {
+    struct timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000LL;
+}
+
+void parse_cpu_times(std::string_view line, CpuTimes& t) {
+    unsigned long long* fields[] = {&t.user, &t.nice, &t.system, &t.idle, &t.iowait,
+                                    &t.irq, &t.softirq, &t.steal, &t.guest, &t.guestNice};
+    for (auto* f : fields) {
+        if (!parse_ull(line, *f)) break;
+    }
+}
+
+// The cpu lines lead the file; the long intr line after them is not needed.
+void parse_proc_stat_cpus(std::string_view content, CpuStatSample& out) {
+    while (!content.empty()) {
+        std::string_view line = next_line(content);
+        std::string_view key = next_token(line);
+        if (key.size() < 3 || key.compare(0, 3, "cpu") != 0) break;
+        if (key.size() == 3) {
+            parse_cpu_times(line, out.aggregate);
+            continue;
+        }
+        std::string_view num = key.substr(3);
+        unsigned long long cpu = 0;
+        if (!parse_ull(num, cpu) || cpu > 4096) continue;
+        if (out.cpus.size() <= cpu) {
+            out.cpus.resize(cpu + 1);
+            out.online.resize(cpu + 1, false);
+        }
+        parse_cpu_times(line, out.cpus[cpu]);
+        out.online[cpu] = true;
+    }
+}
+
+// Counters that went backwards (CPU hotplug resets a core's line) give 0.
+double busy_percent(const CpuTimes& prev, const CpuTimes& cur) {
+    unsigned long long total = cur.total();
+    unsigned long long idle = cur.idleAll();
+    unsigned long long prevTotal = prev.total();
+    unsigned long long prevIdle = prev.idleAll();
+    if (total <= prevTotal || idle < prevIdle) return 0.0;
+    unsigned long long delta_total = total - prevTotal;
+    unsigned long long delta_idle = idle - prevIdle;
+    if (delta_idle > delta_total) return 0.0;
+    return (double(delta_total - delta_idle) / double(delta_total)) * 100.0;
+}
+
+} // namespace
+
+std::shared_ptr<const CpuStatSample> sample_cpu_stat() {
+    std::lock_guard<std::mutex> lock(g_stat_mutex);
+    long long now = now_ms();
+    if (g_stat_latest && now - g_stat_latest->takenAtMs < kCpuStatCoalesceMs) return g_stat_latest;
+
+    auto sample = std::make_shared<CpuStatSample>();
+    sample->seq = g_stat_latest ? g_stat_latest->seq + 1 : 1;
+    sample->takenAtMs = now;
+    parse_proc_stat_cpus(cached_read_view("/proc/stat"), *sample);
+    g_stat_latest = sample;
+    return g_stat_latest;
+}
+
+double advance_cpu_cursor(CpuStatCursor& cursor, const CpuStatSample& sample) {
+    if (cursor.seq == sample.seq) return cursor.busyPercent;
+    double percent = cursor.seq != 0 ? busy_percent(cursor.aggregate, sample.aggregate) : 0.0;
+    cursor.seq = sample.seq;
+    cursor.aggregate = sample.aggregate;
+    cursor.busyPercent = percent;
+    return percent;
+}
+
+double advance_cpu_cursor_per_core(CpuStatCursor& cursor, const CpuStatSample& sample) {
+    if (cursor.seq == sample.seq) return cursor.busyPercent;
+    bool first = cursor.seq == 0;
+    size_t n = sample.cpus.size();
+    cursor.cpuBusyPercent.assign(n, -1.0);
+    for (size_t i = 0; i < n; ++i) {
+        if (!sample.online[i]) continue;
+        // A CPU that just came back has no usable baseline yet.
+        bool hadBaseline = i < cursor.cpus.size() && cursor.cpus[i].total() > 0;
+        cursor.cpuBusyPercent[i] = (!first && hadBaseline) ? busy_percent(cursor.cpus[i], sample.cpus[i]) : 0.0;
+    }
+    cursor.cpus.assign(n, CpuTimes{});
+    for (size_t i = 0; i < n; ++i) {
+        if (sample.online[i]) cursor.cpus[i] = sample.cpus[i];
+    }
+    return advance_cpu_cursor(cursor, sample);
+}
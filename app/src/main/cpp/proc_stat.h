@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+// Jiffies from one "cpu" / "cpuN" line of /proc/stat.
+struct CpuTimes {
+    unsigned long long user = 0;
+    unsigned long long nice = 0;
+    unsigned long long system = 0;
+    unsigned long long idle = 0;
+    unsigned long long iowait = 0;
+    unsigned long long irq = 0;
+    unsigned long long softirq = 0;
+    unsigned long long steal = 0;
+    unsigned long long guest = 0;
+    unsigned long long guestNice = 0;
+
+    unsigned long long total() const {
+        return user + nice + system + idle + iowait + irq + softirq + steal + guest + guestNice;
+    }
+    unsigned long long idleAll() const { return idle + iowait; }
+};
+
+// One parse of /proc/stat. cpus is indexed by CPU number; offline CPUs have
+// no line and keep online = false.
+struct CpuStatSample {
+    unsigned long long seq = 0;
+    long long takenAtMs = 0;
+    CpuTimes aggregate;
+    std::vector<CpuTimes> cpus;
+    std::vector<bool> online;
+};
+
+// Reads closer together than this share one sample, so everything a single
+// refresh asks for comes from the same parse.
+constexpr long long kCpuStatCoalesceMs = 50;
+
+// Latest /proc/stat sample, re-read only when the cached one is older than
+// kCpuStatCoalesceMs. Never null; an unreadable file yields zeroed counters.
+std::shared_ptr<const CpuStatSample> sample_cpu_stat();
+
+// A consumer's own baseline. Each caller that wants "busy % since my last
+// look" keeps one, so consumers no longer disturb each other's windows.
+struct CpuStatCursor {
+    unsigned long long seq = 0;
+    CpuTimes aggregate;
+    double busyPercent = 0.0;
+
+    // Filled only by advance_cpu_cursor_per_core. cpuBusyPercent is -1 for
+    // an offline CPU.
+    std::vector<CpuTimes> cpus;
+    std::vector<double> cpuBusyPercent;
+};
+
+// Busy share of the aggregate line between the cursor and sample, then moves
+// the cursor to sample. Returns 0 on the first call and the previous value
+// when sample is the one the cursor already holds.
+double advance_cpu_cursor(CpuStatCursor& cursor, const CpuStatSample& sample);
+
+// Same, and also fills cursor.cpuBusyPercent from the cpuN lines.
+double advance_cpu_cursor_per_core(CpuStatCursor& cursor, const CpuStatSample& sample);
@@ -1,13 +1,14 @@
 #include "process_detail.h"
 #include "native_utils.h"
+#include "page_cache.h"
+#include "proc_reader.h"
 
-#include <fstream>
 #include <sstream>
-#include <unordered_set>
 #include <unordered_map>
 #include <vector>
 #include <algorithm>
 #include <sys/stat.h>
+#include <fcntl.h>
 #include <dirent.h>
 #include <unistd.h>
 #include <limits.h>
@@ -16,69 +17,94 @@
 #include <cerrno>
 #include <cstring>
 #include <iomanip>
+#include <mutex>
 
 static std::unordered_map<std::string, std::unordered_map<std::string, unsigned long long>> g_prev_thread_counter_by_pid;
 static std::unordered_map<std::string, std::unordered_map<std::string, double>> g_prev_thread_share_by_pid;
 
+bool parse_proc_stat(const char* data, size_t len, ProcStat& out) {
+    // comm (field 2) may contain spaces and parentheses, so fields are
+    // counted from the last ')' rather than from the start of the line.
+    const char* end = data + len;
+    const char* p = end;
+    while (p > data && *(p - 1) != ')') --p;
+    if (p == data) return false;
+
+    int field = 3;
+    while (p < end && field <= 39) {
+        while (p < end && *p == ' ') ++p;
+        if (p >= end || *p == '\n') break;
+        const char* tok = p;
+        while (p < end && *p != ' ' && *p != '\n') ++p;
+        switch (field) {
+            case 3:  out.state = *tok; break;
+            case 4:  out.ppid = (int)std::strtol(tok, nullptr, 10); break;
+            case 10: out.minflt = std::strtoull(tok, nullptr, 10); break;
+            case 12: out.majflt = std::strtoull(tok, nullptr, 10); break;
+            case 14: out.utime = std::strtoull(tok, nullptr, 10); break;
+            case 15: out.stime = std::strtoull(tok, nullptr, 10); break;
+            case 18: out.priority = std::strtol(tok, nullptr, 10); break;
+            case 19: out.nice = std::strtol(tok, nullptr, 10); break;
+            case 20: out.num_threads = std::strtol(tok, nullptr, 10); break;
+            case 22: out.starttime = std::strtoull(tok, nullptr, 10); break;
+            case 24: out.rss = std::strtol(tok, nullptr, 10); break;
+            case 39: out.processor = (int)std::strtol(tok, nullptr, 10); break;
+            default: break;
+        }
+        ++field;
+    }
+    // Everything up to rss is present on every kernel we support.
+    return field > 24;
+}
+
+bool read_proc_stat_file(const std::string& path, ProcStat& out) {
+    char buf[1024];
+    ssize_t n = read_file_into(path.c_str(), buf, sizeof(buf));
+    if (n <= 0) return false;
+    return parse_proc_stat(buf, (size_t)n, out);
+}
+
+bool read_proc_stat(const std::string& pid, ProcStat& out) {
+    return read_proc_stat_file("/proc/" + pid + "/stat", out);
+}
+
 std::string getProcessName(const std::string& pid) {
-    std::string name;
+    char buf[4096];
     std::string cmdlinePath = "/proc/" + pid + "/cmdline";
-    std::ifstream cmdlineFile(cmdlinePath);
-    if (cmdlineFile.is_open()) {
-        std::getline(cmdlineFile, name, '\0');
-        cmdlineFile.close();
+    ssize_t n = read_file_into(cmdlinePath.c_str(), buf, sizeof(buf));
+    if (n > 0 && buf[0] != '\0') {
+        // argv[0] ends at the first NUL; read_file_into() terminates the buffer.
+        return std::string(buf);
     }
-    if (name.empty()) {
-        std::string commPath = "/proc/" + pid + "/comm";
-        std::ifstream commFile(commPath);
-        if (commFile.is_open()) {
-            std::getline(commFile, name);
-            commFile.close();
-            if (!name.empty() && name.back() == '\n') {
-                name.pop_back();
-            }
-        }
+    std::string commPath = "/proc/" + pid + "/comm";
+    n = read_file_into(commPath.c_str(), buf, sizeof(buf));
+    if (n > 0) {
+        std::string_view content(buf, (size_t)n);
+        std::string_view name = next_line(content);
+        if (!name.empty()) return std::string(name);
     }
-    return name.empty() ? "Unknown" : name;
+    return "Unknown";
 }
 
-long getProcessRamBytes(const std::string& pid, long pageSize) {
-    std::string statPath = "/proc/" + pid + "/stat";
-    std::ifstream statFile(statPath);
-    if (!statFile.is_open()) return 0;
-    std::string content((std::istreambuf_iterator<char>(statFile)), std::istreambuf_iterator<char>());
-    statFile.close();
-    size_t lastParen = content.rfind(')');
-    if (lastParen == std::string::npos) return 0;
-    std::string tail = content.substr(lastParen + 1);
-    std::stringstream ss(tail);
-    std::string token;
-    for (int i = 0; i < 21; ++i) {
-        if (!(ss >> token)) return 0;
-    }
-    if (ss >> token) {
-        try {
-            long rssPages = std::stol(token);
-            return rssPages * pageSize;
-        } catch (...) {
-            return 0;
+std::string getProcessName(const BatchRead& cmdline, const std::string& pid) {
+    if (cmdline.ok() && cmdline.data[0] != '\0') {
+        // A slot filled to the brim may have cut argv[0]; reread it in full.
+        size_t len = strnlen(cmdline.data, (size_t)cmdline.size);
+        if (len < (size_t)cmdline.size || (size_t)cmdline.size < cmdline.cap - 1) {
+            return std::string(cmdline.data, len);
         }
     }
-    return 0;
+    return getProcessName(pid);
 }
 
 std::string get_status_field(const std::string& pid, const std::string& field) {
-    std::ifstream statusFile("/proc/" + pid + "/status");
-    std::string line;
-    while (std::getline(statusFile, line)) {
-        if (line.rfind(field, 0) == 0) {
+    std::string_view content = read_file_view(("/proc/" + pid + "/status").c_str());
+    while (!content.empty()) {
+        std::string_view line = next_line(content);
+        if (line.compare(0, field.size(), field) == 0) {
             size_t colon = line.find(':');
-            if (colon != std::string::npos) {
-                std::string val = line.substr(colon + 1);
-                size_t first = val.find_first_not_of(" \t");
-                if (first == std::string::npos) return "";
-                size_t last = val.find_last_not_of(" \t");
-                return val.substr(first, (last - first + 1));
+            if (colon != std::string_view::npos) {
+                return std::string(trim_view(line.substr(colon + 1)));
             }
         }
     }
@@ -97,143 +123,90 @@ std::string get_exe_path(const std::string& pid) {
 }
 
 std::string get_oom_score(const std::string& pid) {
-    std::ifstream oomFile("/proc/" + pid + "/oom_score");
-    std::string score;
-    if (oomFile >> score) return score;
-    return "N/A";
+    long long score = 0;
+    if (!read_ll_file(("/proc/" + pid + "/oom_score").c_str(), score)) return "N/A";
+    return std::to_string(score);
 }
 
 long get_system_uptime() {
-    std::ifstream uptimeFile("/proc/uptime");
-    double uptime = 0;
-    if (uptimeFile >> uptime) return (long)uptime;
-    return 0;
+    long long uptime = 0;
+    if (!read_ll_file("/proc/uptime", uptime)) return 0;
+    return (long)uptime;
 }
 
 long get_process_elapsed_time(const std::string& pid) {
-    std::string statPath = "/proc/" + pid + "/stat";
-    std::ifstream statFile(statPath);
-    if (!statFile.is_open()) return 0;
-    std::string content((std::istreambuf_iterator<char>(statFile)), std::istreambuf_iterator<char>());
-    statFile.close();
-    size_t lastParen = content.rfind(')');
-    if (lastParen == std::string::npos) return 0;
-    std::string tail = content.substr(lastParen + 1);
-    std::stringstream ss(tail);
-    std::string token;
-    for (int i = 0; i < 19; ++i) {
-        if (!(ss >> token)) return 0;
-    }
-    if (ss >> token) {
-        try {
-            unsigned long long start_ticks = std::stoull(token);
-            long clk_tck = sysconf(_SC_CLK_TCK);
-            long uptime = get_system_uptime();
-            long process_seconds = start_ticks / clk_tck;
-            return uptime - process_seconds;
-        } catch (...) {
-            return 0;
-        }
-    }
-    return 0;
+    ProcStat st;
+    if (!read_proc_stat(pid, st)) return 0;
+    long clk_tck = sysconf(_SC_CLK_TCK);
+    if (clk_tck <= 0) return 0;
+    long uptime = get_system_uptime();
+    long process_seconds = (long)(st.starttime / (unsigned long long)clk_tck);
+    return uptime - process_seconds;
 }
 
 void get_sched_info(const std::string& pid, std::string& priority, std::string& nice) {
-    std::string statPath = "/proc/" + pid + "/stat";
-    std::ifstream statFile(statPath);
-    if (!statFile.is_open()) return;
-    std::string content((std::istreambuf_iterator<char>(statFile)), std::istreambuf_iterator<char>());
-    statFile.close();
-    size_t lastParen = content.rfind(')');
-    if (lastParen == std::string::npos) return;
-    std::string tail = content.substr(lastParen + 1);
-    std::stringstream ss(tail);
-    std::string token;
-    for (int i = 0; i < 15; ++i) ss >> token;
-    if (ss >> token) priority = token;
-    if (ss >> token) nice = token;
+    ProcStat st;
+    if (!read_proc_stat(pid, st)) return;
+    priority = std::to_string(st.priority);
+    nice = std::to_string(st.nice);
 }
 
-struct ModuleInfo {
-    std::string path;
-    long size;
-};
-
-std::vector<std::string> get_modules_list(const std::string& pid) {
-    std::vector<std::string> modules;
-    std::ifstream mapsFile("/proc/" + pid + "/maps");
-    if (!mapsFile.is_open()) {
-        return modules;
-    }
-
-    std::string line;
-    std::unordered_set<std::string> uniquePaths;
-    std::unordered_map<std::string, long> moduleSizes;
-
-    while (std::getline(mapsFile, line)) {
-        try {
-            size_t dashPos = line.find('-');
-            size_t spacePos = line.find(' ');
-
-            if (dashPos != std::string::npos && spacePos != std::string::npos) {
-                std::string startStr = line.substr(0, dashPos);
-                std::string endStr = line.substr(dashPos + 1, spacePos - (dashPos + 1));
-
-                unsigned long long start = std::strtoull(startStr.c_str(), nullptr, 16);
-                unsigned long long end = std::strtoull(endStr.c_str(), nullptr, 16);
-                long mappedSize = (long)(end - start);
-
-                size_t pathPos = line.find('/');
-                if (pathPos != std::string::npos) {
-                    std::string path = line.substr(pathPos);
-                    size_t last = path.find_last_not_of(" \t\n\r");
-                    if (last != std::string::npos) path = path.substr(0, last + 1);
-
-                    if (path.find(".so") != std::string::npos ||
-                        path.find(".apk") != std::string::npos ||
-                        path.find(".dex") != std::string::npos ||
-                        path.find(".oat") != std::string::npos ||
-                        path.find(".jar") != std::string::npos ||
-                        path.find(".ttf") != std::string::npos) {
-
-                        uniquePaths.insert(path);
-                        moduleSizes[path] += mappedSize;
-                    }
-                }
-            }
-        } catch (...) {
-            continue;
-        }
+namespace {
+
+// On-disk sizes of mapped files, shared by every process that maps them.
+std::mutex g_file_size_mutex;
+std::unordered_map<MappedFileKey, long long, MappedFileKeyHash> g_file_size_by_inode;
+
+// 0 when the mapped file cannot be opened as itself. Only verified sizes are
+// cached: the key names the file, so its size is good for as long as the
+// cache keeps it.
+long long module_file_size(const MappedModule& m) {
+    MappedFileKey key = m.key();
+    {
+        std::lock_guard<std::mutex> lock(g_file_size_mutex);
+        auto it = g_file_size_by_inode.find(key);
+        if (it != g_file_size_by_inode.end()) return it->second;
     }
-
-    std::vector<ModuleInfo> sortedModules;
     struct stat st;
+    int fd = open_mapped_file(m, st);
+    if (fd < 0) return 0;
+    close(fd);
+    std::lock_guard<std::mutex> lock(g_file_size_mutex);
+    if (g_file_size_by_inode.size() >= kModuleFileCacheMax) g_file_size_by_inode.clear();
+    g_file_size_by_inode[key] = st.st_size;
+    return st.st_size;
+}
 
-    for (const auto& path : uniquePaths) {
-        long finalSize = 0;
-
-        if (stat(path.c_str(), &st) == 0) {
-            finalSize = st.st_size;
-        }
-
-        if (finalSize <= 0) {
-            finalSize = moduleSizes[path];
-        }
+} // namespace
 
-        sortedModules.push_back({path, finalSize});
+std::vector<std::string> get_modules_list(const std::vector<MappedModule>& mapped, bool withPageCache) {
+    std::vector<const MappedModule*> sorted;
+    for (const MappedModule& m : mapped) {
+        if (is_module_file(m.path)) sorted.push_back(&m);
     }
-
-    std::sort(sortedModules.begin(), sortedModules.end(), [](const ModuleInfo& a, const ModuleInfo& b) {
-        return a.size > b.size;
+    std::sort(sorted.begin(), sorted.end(), [](const MappedModule* a, const MappedModule* b) {
+        if (a->pssKb != b->pssKb) return a->pssKb > b->pssKb;
+        return a->rssKb > b->rssKb;
     });
 
-    for (const auto& mod : sortedModules) {
-        size_t slash = mod.path.rfind('/');
-        std::string filename = (slash != std::string::npos) ? mod.path.substr(slash + 1) : mod.path;
-
-        modules.push_back(filename + "|" + mod.path + "|" + std::to_string(mod.size));
+    std::vector<std::string> modules;
+    modules.reserve(sorted.size());
+    for (const MappedModule* m : sorted) {
+        long long size = module_file_size(*m);
+        if (size <= 0) size = (long long)m->sizeKb * 1024LL;
+
+        size_t slash = m->path.rfind('/');
+        std::string filename = (slash != std::string::npos) ? m->path.substr(slash + 1) : m->path;
+
+        std::stringstream ss;
+        ss << filename << "|" << m->path << "|" << size << "|" << m->rssKb * 1024ULL << "|" << m->pssKb * 1024ULL
+           << "|" << std::hex << m->devMajor << ":" << m->devMinor << std::dec << "|" << m->inode;
+        if (withPageCache) {
+            PageCacheResidency residency;
+            ss << "|" << (file_page_cache(*m, residency) ? residency.cachedBytes : -1LL);
+        }
+        modules.push_back(ss.str());
     }
-
     return modules;
 }
 
@@ -263,65 +236,24 @@ std::vector<std::string> get_threads_list(const std::string& pid) {
             std::string tid = entry->d_name;
             if (tid.find_first_not_of("0123456789") == std::string::npos) {
                 std::string commPath = taskPath + "/" + tid + "/comm";
-                std::ifstream commFile(commPath);
-                std::string name = "Unknown";
-                if (commFile.is_open()) {
-                    std::getline(commFile, name);
-                    if (!name.empty() && name.back() == '\n') name.pop_back();
-                }
+                std::string name = read_first_line(commPath);
+                if (name.empty()) name = "Unknown";
                 int prio = 0;
-                std::string statPath = taskPath + "/" + tid + "/stat";
-                std::ifstream statFile(statPath);
-                if (statFile.is_open()) {
-                    std::string content((std::istreambuf_iterator<char>(statFile)),
-                                        std::istreambuf_iterator<char>());
-                    size_t lastParen = content.rfind(')');
-                    if (lastParen != std::string::npos) {
-                        std::string tail = content.substr(lastParen + 1);
-                        std::stringstream ss(tail);
-                        std::vector<std::string> fields;
-                        std::string token;
-                        while (ss >> token) fields.push_back(token);
-                        if (fields.size() > 15) {
-                            try {
-                                prio = std::stoi(fields[15]); // stat field 18: priority
-                            } catch (...) {
-                                prio = 0;
-                            }
-                        }
-                        unsigned long long threadTicks = 0;
-                        if (fields.size() > 12) {
-                            try {
-                                unsigned long long utime = std::stoull(fields[11]); // stat field 14
-                                unsigned long long stime = std::stoull(fields[12]); // stat field 15
-                                threadTicks = utime + stime;
-                            } catch (...) {
-                                threadTicks = 0;
-                            }
-                        }
-                        unsigned long long runtimeNs = 0;
-                        std::ifstream schedstatFile(taskPath + "/" + tid + "/schedstat");
-                        if (schedstatFile.is_open()) {
-                            schedstatFile >> runtimeNs;
-                        }
-                        unsigned long long counter = (runtimeNs > 0) ? runtimeNs : threadTicks;
-                        int lastCpu = -1;
-                        if (fields.size() > 36) {
-                            try {
-                                lastCpu = std::stoi(fields[36]); // stat field 39: processor
-                            } catch (...) {
-                                lastCpu = -1;
-                            }
-                        }
-                        unsigned long long delta = 0;
-                        auto itPrev = prevCounters.find(tid);
-                        if (itPrev != prevCounters.end() && counter >= itPrev->second) {
-                            delta = counter - itPrev->second;
-                        }
-                        currentCounters[tid] = counter;
-                        entries.push_back({tid, name, prio, lastCpu, delta, 0.0});
-                        continue;
+                ProcStat st;
+                if (read_proc_stat_file(taskPath + "/" + tid + "/stat", st)) {
+                    prio = (int)st.priority;
+                    unsigned long long threadTicks = st.utime + st.stime;
+                    long long runtimeNs = 0;
+                    read_ll_file((taskPath + "/" + tid + "/schedstat").c_str(), runtimeNs);
+                    unsigned long long counter = (runtimeNs > 0) ? (unsigned long long)runtimeNs : threadTicks;
+                    unsigned long long delta = 0;
+                    auto itPrev = prevCounters.find(tid);
+                    if (itPrev != prevCounters.end() && counter >= itPrev->second) {
+                        delta = counter - itPrev->second;
                     }
+                    currentCounters[tid] = counter;
+                    entries.push_back({tid, name, prio, st.processor, delta, 0.0});
+                    continue;
                 }
                 currentCounters[tid] = 0;
                 entries.push_back({tid, name, prio, -1, 0, 0.0});
@@ -367,52 +299,38 @@ std::vector<std::string> get_threads_list(const std::string& pid) {
 }
 
 void get_detailed_status(const std::string& pid, std::unordered_map<std::string, std::string>& out) {
-    std::ifstream statusFile("/proc/" + pid + "/status");
-    std::string line;
-    while (std::getline(statusFile, line)) {
-        if (line.rfind("voluntary_ctxt_switches:", 0) == 0) {
-            out["voluntary_ctxt_switches"] = line.substr(25);
-        } else if (line.rfind("nonvoluntary_ctxt_switches:", 0) == 0) {
-            out["nonvoluntary_ctxt_switches"] = line.substr(28);
+    std::string_view content = read_file_view(("/proc/" + pid + "/status").c_str());
+    while (!content.empty()) {
+        std::string_view line = next_line(content);
+        if (line.compare(0, 24, "voluntary_ctxt_switches:") == 0) {
+            out["voluntary_ctxt_switches"] = std::string(trim_view(line.substr(24)));
+        } else if (line.compare(0, 27, "nonvoluntary_ctxt_switches:") == 0) {
+            out["nonvoluntary_ctxt_switches"] = std::string(trim_view(line.substr(27)));
         }
     }
 }
 
 void get_page_faults(const std::string& pid, std::unordered_map<std::string, std::string>& out) {
-    std::string statPath = "/proc/" + pid + "/stat";
-    std::ifstream statFile(statPath);
-    if (!statFile.is_open()) return;
-
-    std::string content((std::istreambuf_iterator<char>(statFile)), std::istreambuf_iterator<char>());
-    statFile.close();
-
-    size_t lastParen = content.rfind(')');
-    if (lastParen == std::string::npos) return;
-    std::string tail = content.substr(lastParen + 1);
-    std::stringstream ss(tail);
-    std::string token;
-
-    for (int i = 3; i < 10; ++i) ss >> token;
-
-    if (ss >> token) out["minflt"] = token;
-    ss >> token;
-    if (ss >> token) out["majflt"] = token;
+    ProcStat st;
+    if (!read_proc_stat(pid, st)) return;
+    out["minflt"] = std::to_string(st.minflt);
+    out["majflt"] = std::to_string(st.majflt);
 }
 
 void get_io_syscall_counts(const std::string& pid, unsigned long long& syscr, unsigned long long& syscw) {
     syscr = 0;
     syscw = 0;
-    std::ifstream ioFile("/proc/" + pid + "/io");
-    if (!ioFile.is_open()) return;
-
-    std::string line;
-    while (std::getline(ioFile, line)) {
-        if (line.rfind("syscr:", 0) == 0) {
-            std::stringstream ss(line.substr(6));
-            ss >> syscr;
-        } else if (line.rfind("syscw:", 0) == 0) {
-            std::stringstream ss(line.substr(6));
-            ss >> syscw;
+    char buf[512];
+    if (read_file_into(("/proc/" + pid + "/io").c_str(), buf, sizeof(buf)) <= 0) return;
+
+    std::string_view content(buf);
+    while (!content.empty()) {
+        std::string_view line = next_line(content);
+        long long value = 0;
+        if (parse_keyed_ll(line, "syscr:", value)) {
+            syscr = (unsigned long long)value;
+        } else if (parse_keyed_ll(line, "syscw:", value)) {
+            syscw = (unsigned long long)value;
         }
     }
 }
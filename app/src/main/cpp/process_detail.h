@@ -4,8 +4,32 @@
 #include <vector>
 #include <unordered_map>
 
+#include "batch_reader.h"
+#include "process_smaps.h"
+
+// Fields of /proc/<pid>/stat the backend consumes, filled from a single read.
+struct ProcStat {
+    char state = '?';
+    int ppid = 0;
+    unsigned long long minflt = 0;
+    unsigned long long majflt = 0;
+    unsigned long long utime = 0;
+    unsigned long long stime = 0;
+    long priority = 0;
+    long nice = 0;
+    long num_threads = 0;
+    unsigned long long starttime = 0;
+    long rss = 0;
+    int processor = -1;
+};
+
+bool parse_proc_stat(const char* data, size_t len, ProcStat& out);
+bool read_proc_stat_file(const std::string& path, ProcStat& out);
+bool read_proc_stat(const std::string& pid, ProcStat& out);
+
 std::string getProcessName(const std::string& pid);
-long getProcessRamBytes(const std::string& pid, long pageSize);
+// Same, from a batched /proc/<pid>/cmdline read; falls back to a direct read.
+std::string getProcessName(const BatchRead& cmdline, const std::string& pid);
 std::string get_status_field(const std::string& pid, const std::string& field);
 std::string get_exe_path(const std::string& pid);
 std::string get_oom_score(const std::string& pid);
@@ -13,7 +37,16 @@ long get_system_uptime();
 long get_process_elapsed_time(const std::string& pid);
 void get_sched_info(const std::string& pid, std::string& priority, std::string& nice);
 
-std::vector<std::string> get_modules_list(const std::string& pid);
+// The stat() size cache shared across processes is cleared when it reaches
+// this many files.
+constexpr size_t kModuleFileCacheMax = 4096;
+
+// "filename|path|fileSizeBytes|rssBytes|pssBytes|dev|inode" per mapped
+// .so/.apk/.dex/.oat/.jar/.ttf, largest PSS first. dev is "major:minor" in
+// hex as in /proc/<pid>/maps; the file size falls back to the mapped size.
+// withPageCache appends "|cachedBytes" from file_page_cache(), -1 when the
+// file could not be measured.
+std::vector<std::string> get_modules_list(const std::vector<MappedModule>& mapped, bool withPageCache = false);
 std::vector<std::string> get_threads_list(const std::string& pid);
 void get_detailed_status(const std::string& pid, std::unordered_map<std::string, std::string>& out);
 void get_page_faults(const std::string& pid, std::unordered_map<std::string, std::string>& out);
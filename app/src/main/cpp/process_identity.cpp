@@ -0,0 +1,126 @@
+#include "process_identity.h"
+#include "batch_reader.h"
+#include "process_detail.h"
+#include "proc_reader.h"
+
+#include <ctime>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+struct IdentityEntry {
+    unsigned long long starttime = 0;
+    ProcessIdentity identity;
+    long long firstSeenMs = 0;
+    long long refreshAtMs = 0;
+};
+
+std::mutex g_identity_mutex;
+std::unordered_map<int, IdentityEntry> g_identities;
+std::unordered_map<std::string, std::shared_ptr<const std::string>> g_names;
+
+long long now_ms() {
+    struct timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000LL;
+}
+
+std::shared_ptr<const std::string> intern_name_locked(std::string name) {
+    auto it = g_names.find(name);
+    if (it != g_names.end()) return it->second;
+    auto shared = std::make_shared<const std::string>(name);
+    g_names.emplace(std::move(name), shared);
+    return shared;
+}
+
+// Between half and one and a half refresh intervals from now, fixed per PID.
+long long next_refresh_ms(int pid, long long now) {
+    unsigned long long spread = ((unsigned long long)(unsigned)pid * 2654435761u) % (unsigned long long)kIdentityRefreshMs;
+    return now + kIdentityRefreshMs / 2 + (long long)spread;
+}
+
+bool needs_refresh_locked(const IdentityEntry& entry, long long now) {
+    if (now >= entry.refreshAtMs) return true;
+    if (now - entry.firstSeenMs >= kIdentitySettleMs) return false;
+    auto parent = g_identities.find(entry.identity.ppid);
+    return parent != g_identities.end() && parent->second.identity.name == entry.identity.name;
+}
+
+int parse_uid(std::string_view status) {
+    long long uid = -1;
+    while (!status.empty()) {
+        if (parse_keyed_ll(next_line(status), "Uid:", uid)) break;
+    }
+    return (int)uid;
+}
+
+} // namespace
+
+std::vector<ProcessIdentity> resolve_process_identities(const std::vector<IdentityRequest>& procs) {
+    std::lock_guard<std::mutex> lock(g_identity_mutex);
+    long long now = now_ms();
+    std::vector<ProcessIdentity> out(procs.size());
+
+    std::vector<size_t> misses;
+    for (size_t i = 0; i < procs.size(); ++i) {
+        auto it = g_identities.find(procs[i].pid);
+        if (it != g_identities.end() && it->second.starttime == procs[i].starttime &&
+            !needs_refresh_locked(it->second, now)) {
+            out[i] = it->second.identity;
+        } else {
+            misses.push_back(i);
+        }
+    }
+    if (misses.empty()) return out;
+
+    std::vector<BatchRead> reads(misses.size() * 2);
+    for (size_t j = 0; j < misses.size(); ++j) {
+        std::string base = "/proc/" + std::to_string(procs[misses[j]].pid);
+        reads[2 * j].path = base + "/cmdline";
+        reads[2 * j].cap = 512;
+        // Deliberately truncated: only Uid: is parsed, the 9th line, well
+        // inside the first 1 KB of a ~1.5 KB file.
+        reads[2 * j + 1].path = base + "/status";
+        reads[2 * j + 1].cap = 1024;
+    }
+    batch_read(reads);
+
+    for (size_t j = 0; j < misses.size(); ++j) {
+        const IdentityRequest& req = procs[misses[j]];
+        std::string pid_str = std::to_string(req.pid);
+        IdentityEntry& entry = g_identities[req.pid];
+        bool sameProcess = entry.identity.name && entry.starttime == req.starttime;
+        if (!sameProcess) {
+            entry.starttime = req.starttime;
+            entry.firstSeenMs = now;
+        }
+        entry.identity.name = intern_name_locked(getProcessName(reads[2 * j], pid_str));
+        entry.identity.uid = parse_uid(reads[2 * j + 1].view());
+        entry.identity.ppid = req.ppid;
+        entry.refreshAtMs = next_refresh_ms(req.pid, now);
+        out[misses[j]] = entry.identity;
+    }
+    return out;
+}
+
+void prune_process_identities(const std::vector<int>& livePids) {
+    std::unordered_set<int> live(livePids.begin(), livePids.end());
+    std::lock_guard<std::mutex> lock(g_identity_mutex);
+    for (auto it = g_identities.begin(); it != g_identities.end(); ) {
+        if (live.find(it->first) == live.end()) {
+            it = g_identities.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = g_names.begin(); it != g_names.end(); ) {
+        // Only the pool itself still holds the name.
+        if (it->second.use_count() == 1) {
+            it = g_names.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
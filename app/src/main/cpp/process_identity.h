@@ -0,0 +1,34 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// Per-process facts that almost never change over a process's lifetime.
+// name is interned: every PID with the same name shares one string.
+struct ProcessIdentity {
+    std::shared_ptr<const std::string> name;
+    int uid = -1;
+    int ppid = 0;
+};
+
+struct IdentityRequest {
+    int pid;
+    unsigned long long starttime;  // /proc/<pid>/stat field 22
+    int ppid;
+};
+
+// Cache of ProcessIdentity keyed by (pid, starttime), so a reused PID is
+// never served its predecessor's name. Entries are (re)read when the PID is
+// new, every kIdentityRefreshMs give or take half of it (spread by PID, so
+// entries filled by the same scan do not all expire together), and on every
+// lookup while a freshly seen process still carries its parent's name (a
+// zygote child before setArgv0).
+constexpr long long kIdentityRefreshMs = 10000;
+constexpr long long kIdentitySettleMs = 5000;
+
+// Returns one identity per request, batching the reads for the misses.
+std::vector<ProcessIdentity> resolve_process_identities(const std::vector<IdentityRequest>& procs);
+
+// Drops entries for PIDs not in livePids and names no longer referenced.
+void prune_process_identities(const std::vector<int>& livePids);
@@ -3,98 +3,488 @@
 #include "system_stats.h"
 #include "process_detail.h"
 #include "native_utils.h"
+#include "batch_reader.h"
+#include "process_identity.h"
+#include "pid_table.h"
+#include "proc_reader.h"
+#include "proc_stat.h"
 
-#include <dirent.h>
+#include <atomic>
+#include <climits>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <deque>
+#include <fcntl.h>
+#include <memory>
 #include <unistd.h>
-#include <unordered_map>
-#include <unordered_set>
+#include <mutex>
 #include <sstream>
-#include <fstream>
+#include <vector>
+#include <algorithm>
 
-struct ProcessHistory {
-    unsigned long long proc_ticks;
-    unsigned long long sys_ticks;
+struct ScanRow {
+    int pid;
+    std::shared_ptr<const std::string> name;
+    long ramBytes;
+    unsigned long long ticks;
+    long nice;
+    double cpu;
+    unsigned long long starttime;
+    unsigned long long minflt;
+    unsigned long long majflt;
+    long pssBytes;
+    long ussBytes;
+    long swapPssBytes;
 };
 
-static std::unordered_map<int, ProcessHistory> history_map;
-
-static unsigned long long get_process_ticks(const std::string& pid) {
-    std::string statPath = "/proc/" + pid + "/stat";
-    std::ifstream statFile(statPath);
-    if (!statFile.is_open()) return 0;
-    std::string content((std::istreambuf_iterator<char>(statFile)), std::istreambuf_iterator<char>());
-    statFile.close();
-    size_t lastParen = content.rfind(')');
-    if (lastParen == std::string::npos) return 0;
-    std::string tail = content.substr(lastParen + 1);
-    std::stringstream ss(tail);
-    std::string token;
-    for (int i = 0; i < 11; ++i) {
-        if (!(ss >> token)) return 0;
-    }
-    unsigned long long utime = 0;
-    unsigned long long stime = 0;
-    if (ss >> token) utime = std::stoull(token);
-    if (ss >> token) stime = std::stoull(token);
-    return utime + stime;
-}
-
-std::string build_process_list() {
-    std::stringstream ss;
-    double globalCpu = getGlobalCpuUsage();
-    RamInfo globalRam = getGlobalRamUsage();
-    ss << "HEAD|" << globalCpu << "|" << globalRam.used << "|" << globalRam.total << "\n";
+static constexpr size_t kStatReadCap = 1024;
+
+static std::mutex g_scan_mutex;
+static PidTable g_pids;
+static CpuStatCursor g_cpu_cursor;
+// Generations carry a per-instance epoch in their high bits, so one handed out
+// by an earlier service process never passes for a generation of this one.
+static constexpr unsigned kGenerationEpochShift = 32;
+
+// Nonzero and below 2^31, which keeps generations positive as a jlong.
+static unsigned long long generation_epoch() {
+    unsigned int epoch = 0;
+    int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        if (read(fd, &epoch, sizeof(epoch)) != (ssize_t)sizeof(epoch)) epoch = 0;
+        close(fd);
+    }
+    if (epoch == 0) {
+        struct timespec ts{};
+        clock_gettime(CLOCK_REALTIME, &ts);
+        epoch = (unsigned int)ts.tv_nsec ^ ((unsigned int)ts.tv_sec << 8) ^ (unsigned int)getpid();
+    }
+    epoch &= 0x7fffffffu;
+    return (unsigned long long)(epoch ? epoch : 1) << kGenerationEpochShift;
+}
+
+static unsigned long long g_generation = generation_epoch();
+static std::deque<RemovedPid> g_removed;
+// Totals of the last finished scan, read without g_scan_mutex so a CPU
+// snapshot never waits behind a scan in progress.
+static std::atomic<int> g_scan_processes{0};
+static std::atomic<long> g_scan_threads{0};
+static std::atomic<long long> g_scan_counts_at_ms{0};
+static double g_delta_cpu_threshold = kDefaultDeltaCpuThreshold;
+static long g_delta_ram_threshold = kDefaultDeltaRamThreshold;
+static bool g_pss_enabled = false;
+static long g_pss_budget_us = kDefaultPssBudgetUs;
+
+static long long scan_now_ms() {
+    struct timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000LL;
+}
+
+static long long scan_now_us() {
+    struct timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000LL;
+}
+
+// Pss, Private_Clean + Private_Dirty and SwapPss of one process, in bytes.
+static bool read_smaps_rollup(int pid, long& pss, long& uss, long& swapPss) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/smaps_rollup", pid);
+    char buf[4096];
+    ssize_t n = read_file_into(path, buf, sizeof(buf));
+    if (n <= 0) return false;
+    std::string_view content(buf, (size_t)n);
+    long long pssKb = -1;
+    long long privateCleanKb = 0;
+    long long privateDirtyKb = 0;
+    long long swapPssKb = 0;
+    while (!content.empty()) {
+        std::string_view line = next_line(content);
+        if (parse_keyed_ll(line, "Pss:", pssKb)) continue;
+        if (parse_keyed_ll(line, "Private_Clean:", privateCleanKb)) continue;
+        if (parse_keyed_ll(line, "Private_Dirty:", privateDirtyKb)) continue;
+        parse_keyed_ll(line, "SwapPss:", swapPssKb);
+    }
+    if (pssKb < 0) return false;
+    pss = (long)(pssKb * 1024);
+    uss = (long)((privateCleanKb + privateDirtyKb) * 1024);
+    swapPss = (long)(swapPssKb * 1024);
+    return true;
+}
+
+// Re-reads smaps_rollup for the processes whose memory has moved, within
+// g_pss_budget_us, and copies every row's current PSS figures into it. A
+// changed PSS republishes the row like an RSS change does. A process whose
+// read fails keeps its old baseline and is not retried for kPssMaxAgeMs.
+// Caller holds g_scan_mutex.
+static void refresh_pss_locked(std::vector<ScanRow>& rows, unsigned long long gen) {
+    long long now = scan_now_ms();
+    struct Candidate {
+        PidSlot* slot;
+        ScanRow* row;
+        long priority;
+    };
+    std::vector<Candidate> due;
+    for (ScanRow& row : rows) {
+        PidSlot* slot = g_pids.find(row.pid, gen);
+        if (!slot) continue;
+        if (slot->pssFailedAtMs != 0 && now - slot->pssFailedAtMs < kPssMaxAgeMs) continue;
+        unsigned long long faults = row.minflt + row.majflt;
+        long ramMove = std::labs(row.ramBytes - slot->pssReadRamBytes);
+        if (slot->pssReadAtMs == 0) {
+            due.push_back({slot, &row, LONG_MAX});
+        } else if (ramMove >= kPssRefreshRamBytes || faults - slot->pssReadFaults >= kPssRefreshFaults ||
+                   now - slot->pssReadAtMs >= kPssMaxAgeMs) {
+            due.push_back({slot, &row, ramMove});
+        }
+    }
+    std::sort(due.begin(), due.end(), [](const Candidate& a, const Candidate& b) {
+        return a.priority > b.priority;
+    });
+
+    long long startUs = scan_now_us();
+    for (const Candidate& c : due) {
+        // At least one read per scan, so a tiny budget still makes progress.
+        if (&c != &due.front() && scan_now_us() - startUs >= g_pss_budget_us) break;
+        PidSlot& slot = *c.slot;
+        const ScanRow& row = *c.row;
+        long pss = -1;
+        long uss = -1;
+        long swapPss = -1;
+        if (!read_smaps_rollup(row.pid, pss, uss, swapPss)) {
+            slot.pssFailedAtMs = now;
+            continue;
+        }
+        slot.pssReadRamBytes = row.ramBytes;
+        slot.pssReadFaults = row.minflt + row.majflt;
+        slot.pssReadAtMs = now;
+        slot.pssFailedAtMs = 0;
+        bool changed = slot.pssBytes < 0 || std::labs(slot.pssBytes - pss) >= g_delta_ram_threshold ||
+                       std::labs(slot.ussBytes - uss) >= g_delta_ram_threshold ||
+                       std::labs(slot.swapPssBytes - swapPss) >= g_delta_ram_threshold;
+        if (changed) {
+            slot.pssBytes = pss;
+            slot.ussBytes = uss;
+            slot.swapPssBytes = swapPss;
+            slot.changedGen = gen;
+        }
+    }
+
+    for (ScanRow& row : rows) {
+        const PidSlot* slot = g_pids.find(row.pid, gen);
+        if (!slot) continue;
+        row.pssBytes = slot->pssBytes;
+        row.ussBytes = slot->ussBytes;
+        row.swapPssBytes = slot->swapPssBytes;
+    }
+}
+
+// Drops the PSS columns and baselines once collection is off, republishing
+// every row that still carried values so delta clients do not keep stale
+// figures. Caller holds g_scan_mutex.
+static void clear_pss_locked(const std::vector<ScanRow>& rows, unsigned long long gen) {
+    for (const ScanRow& row : rows) {
+        PidSlot* slot = g_pids.find(row.pid, gen);
+        if (!slot) continue;
+        slot->pssReadRamBytes = 0;
+        slot->pssReadFaults = 0;
+        slot->pssReadAtMs = 0;
+        slot->pssFailedAtMs = 0;
+        if (slot->pssBytes < 0 && slot->ussBytes < 0 && slot->swapPssBytes < 0) continue;
+        slot->pssBytes = -1;
+        slot->ussBytes = -1;
+        slot->swapPssBytes = -1;
+        slot->changedGen = gen;
+    }
+}
+
+// Reads stat for every PID in one batch and takes names from the identity
+// cache, which only touches cmdline for new or renamed processes. Rows come
+// back in /proc order.
+static std::vector<ScanRow> collect_scan_rows(const std::vector<int>& pids, long pageSize,
+                                             int& processCount, long& threadCount) {
+    std::vector<BatchRead> reads(pids.size());
+    for (size_t i = 0; i < pids.size(); ++i) {
+        reads[i].path = "/proc/" + std::to_string(pids[i]) + "/stat";
+        reads[i].cap = kStatReadCap;
+    }
+    batch_read(reads);
+
+    std::vector<ScanRow> rows;
+    std::vector<IdentityRequest> idents;
+    rows.reserve(pids.size());
+    idents.reserve(pids.size());
+    for (size_t i = 0; i < pids.size(); ++i) {
+        ProcStat st;
+        if (!reads[i].ok() || !parse_proc_stat(reads[i].data, (size_t)reads[i].size, st)) continue;
+        processCount++;
+        threadCount += st.num_threads;
+        long ramBytes = st.rss * pageSize;
+        if (ramBytes <= 0) continue;
+        rows.push_back({pids[i], nullptr, ramBytes, st.utime + st.stime, st.nice, 0.0,
+                        st.starttime, st.minflt, st.majflt, -1, -1, -1});
+        idents.push_back({pids[i], st.starttime, st.ppid});
+    }
+
+    std::vector<ProcessIdentity> resolved = resolve_process_identities(idents);
+    std::vector<int> livePids;
+    livePids.reserve(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        rows[i].name = resolved[i].name;
+        livePids.push_back(rows[i].pid);
+    }
+    prune_process_identities(livePids);
+    return rows;
+}
+
+// Samples the global counters for the HEAD line, scans /proc under a new
+// generation and returns every row with its CPU share since the previous
+// scan. Rows are folded into the published delta state as they go: a row is
+// republished only when it is new or has moved past a threshold, so delta
+// clients see the values as of their last change. Caller holds g_scan_mutex.
+static std::vector<ScanRow> scan_processes_locked(double& globalCpu, RamInfo& globalRam,
+                                                 int& processCount, long& threadCount) {
+    // HEAD CPU% and per-process shares come from the same /proc/stat parse.
+    std::shared_ptr<const CpuStatSample> stat = sample_cpu_stat();
+    globalCpu = advance_cpu_cursor(g_cpu_cursor, *stat);
+    globalRam = getGlobalRamUsage();
 
-    DIR* procDir = opendir("/proc");
     long pageSize = sysconf(_SC_PAGESIZE);
-    unsigned long long current_system_ticks = get_total_system_ticks();
-    std::unordered_set<int> current_scan_pids;
-
-    if (procDir == nullptr) {
-        LOGE("Failed to open /proc");
-        return ss.str();
-    }
-
-    struct dirent* entry;
-    while ((entry = readdir(procDir)) != nullptr) {
-        if (entry->d_type == DT_DIR) {
-            std::string pid_str = entry->d_name;
-            if (pid_str.find_first_not_of("0123456789") == std::string::npos) {
-                int pid = std::stoi(pid_str);
-                std::string name = getProcessName(pid_str);
-                long ramBytes = getProcessRamBytes(pid_str, pageSize);
-
-                if (ramBytes > 0) {
-                    unsigned long long current_proc_ticks = get_process_ticks(pid_str);
-                    double cpu_percent = 0.0;
-
-                    if (history_map.count(pid)) {
-                        unsigned long long delta_proc = current_proc_ticks - history_map[pid].proc_ticks;
-                        unsigned long long delta_sys = current_system_ticks - history_map[pid].sys_ticks;
-                        if (delta_sys > 0) {
-                            cpu_percent = (double(delta_proc) / double(delta_sys)) * 100.0;
-                        }
-                    }
-                    history_map[pid] = {current_proc_ticks, current_system_ticks};
-                    current_scan_pids.insert(pid);
-
-                    std::string prio, nice;
-                    get_sched_info(pid_str, prio, nice);
-
-                    ss << pid << "|" << name << "|" << ramBytes << "|" << cpu_percent << "|" << nice << "\n";
-                }
+    unsigned long long current_system_ticks = stat->aggregate.total();
+    unsigned long long gen = ++g_generation;
+    std::vector<int> pids = list_proc_pids();
+    std::vector<ScanRow> rows;
+    if (!pids.empty()) rows = collect_scan_rows(pids, pageSize, processCount, threadCount);
+
+    for (ScanRow& row : rows) {
+        bool prevSeen = false;
+        PidSlot& slot = g_pids.touch(row.pid, gen, prevSeen);
+        bool sameProcess = prevSeen && slot.starttime == row.starttime;
+        if (prevSeen && !sameProcess) {
+            // PID reused between two scans: the previous owner's smaps_rollup
+            // values and baseline must not carry over.
+            slot.pssReadRamBytes = 0;
+            slot.pssReadFaults = 0;
+            slot.pssReadAtMs = 0;
+            slot.pssFailedAtMs = 0;
+            slot.pssBytes = -1;
+            slot.ussBytes = -1;
+            slot.swapPssBytes = -1;
+        }
+        if (sameProcess) {
+            unsigned long long delta_proc = row.ticks - slot.procTicks;
+            unsigned long long delta_sys = current_system_ticks - slot.sysTicks;
+            if (delta_sys > 0) {
+                row.cpu = (double(delta_proc) / double(delta_sys)) * 100.0;
             }
         }
+        slot.starttime = row.starttime;
+        slot.procTicks = row.ticks;
+        slot.sysTicks = current_system_ticks;
+        slot.minflt = row.minflt;
+        slot.majflt = row.majflt;
+
+        bool changed = !sameProcess || *slot.name != *row.name || slot.nice != row.nice ||
+                       std::fabs(slot.cpu - row.cpu) >= g_delta_cpu_threshold ||
+                       std::labs(slot.ramBytes - row.ramBytes) >= g_delta_ram_threshold;
+        if (changed) {
+            slot.name = row.name;
+            slot.ramBytes = row.ramBytes;
+            slot.cpu = row.cpu;
+            slot.nice = row.nice;
+            slot.changedGen = gen;
+        }
     }
-    closedir(procDir);
 
-    for (auto it = history_map.begin(); it != history_map.end(); ) {
-        if (current_scan_pids.find(it->first) == current_scan_pids.end()) {
-            it = history_map.erase(it);
-        } else {
-            ++it;
+    if (g_pss_enabled) {
+        refresh_pss_locked(rows, gen);
+    } else {
+        clear_pss_locked(rows, gen);
+    }
+
+    // Whatever the previous scan saw and this one did not has exited.
+    g_pids.for_each_stamped(gen - 1, [&](const PidSlot& slot) {
+        g_removed.push_back({gen, slot.pid});
+    });
+    while (!g_removed.empty() && g_removed.front().generation + kDeltaHistoryGenerations <= gen) {
+        g_removed.pop_front();
+    }
+
+    return rows;
+}
+
+static void write_head(std::stringstream& ss, double globalCpu, long ramUsed, long ramTotal) {
+    ss << "HEAD|" << globalCpu << "|" << ramUsed << "|" << ramTotal << "\n";
+}
+
+static void write_row(std::stringstream& ss, const ProcessListRow& row) {
+    ss << row.pid << "|" << *row.name << "|" << row.ramBytes << "|" << row.cpu << "|" << row.nice << "\n";
+}
+
+std::shared_ptr<const ProcessSnapshot> scan_process_snapshot() {
+    std::lock_guard<std::mutex> lock(g_scan_mutex);
+    auto snap = std::make_shared<ProcessSnapshot>();
+    RamInfo globalRam{};
+    std::vector<ScanRow> rows =
+        scan_processes_locked(snap->globalCpu, globalRam, snap->processCount, snap->threadCount);
+    snap->ramUsed = globalRam.used;
+    snap->ramTotal = globalRam.total;
+    snap->generation = g_generation;
+
+    snap->rows.reserve(rows.size());
+    for (const ScanRow& row : rows) {
+        snap->rows.push_back({row.pid, row.name, row.ramBytes, row.cpu, row.nice, row.pssBytes, row.ussBytes,
+                              row.swapPssBytes});
+    }
+    snap->published.reserve(rows.size());
+    g_pids.for_each_stamped(g_generation, [&](const PidSlot& slot) {
+        snap->published.push_back({{slot.pid, slot.name, slot.ramBytes, slot.cpu, slot.nice, slot.pssBytes,
+                                    slot.ussBytes, slot.swapPssBytes},
+                                   slot.changedGen});
+    });
+    snap->removed.assign(g_removed.begin(), g_removed.end());
+
+    g_scan_processes.store(snap->processCount, std::memory_order_relaxed);
+    g_scan_threads.store(snap->threadCount, std::memory_order_relaxed);
+    g_scan_counts_at_ms.store(scan_now_ms(), std::memory_order_release);
+    return snap;
+}
+
+bool recent_scan_counts(int& processes, long& threads) {
+    long long at = g_scan_counts_at_ms.load(std::memory_order_acquire);
+    if (at == 0 || scan_now_ms() - at > kScanCountsMaxAgeMs) return false;
+    processes = g_scan_processes.load(std::memory_order_relaxed);
+    threads = g_scan_threads.load(std::memory_order_relaxed);
+    return processes > 0;
+}
+
+std::string build_process_list(const ProcessSnapshot& snap) {
+    std::stringstream ss;
+    write_head(ss, snap.globalCpu, snap.ramUsed, snap.ramTotal);
+    for (const ProcessListRow& row : snap.rows) write_row(ss, row);
+    return ss.str();
+}
+
+ProcessListDelta collect_process_list_delta(const ProcessSnapshot& snap, unsigned long long sinceGeneration) {
+    ProcessListDelta delta;
+    delta.generation = snap.generation;
+    delta.globalCpu = snap.globalCpu;
+    delta.ramUsed = snap.ramUsed;
+    delta.ramTotal = snap.ramTotal;
+
+    // Removals older than the retained window are gone, so a client that far
+    // behind, or holding another service instance's generation, gets the
+    // whole table.
+    delta.full = sinceGeneration == 0 ||
+                 (sinceGeneration >> kGenerationEpochShift) != (snap.generation >> kGenerationEpochShift) ||
+                 sinceGeneration > snap.generation ||
+                 sinceGeneration + kDeltaHistoryGenerations < snap.generation;
+
+    if (!delta.full) {
+        for (const RemovedPid& removed : snap.removed) {
+            if (removed.generation > sinceGeneration) delta.removed.push_back(removed.pid);
         }
     }
+    for (const PublishedProcess& pub : snap.published) {
+        if (!delta.full && pub.changedGen <= sinceGeneration) continue;
+        delta.rows.push_back(pub.row);
+    }
+    return delta;
+}
+
+static bool contains_ignore_case(const std::string& haystack, const std::string& needle) {
+    auto it = std::search(haystack.begin(), haystack.end(), needle.begin(), needle.end(),
+                          [](char a, char b) {
+                              return std::tolower((unsigned char)a) == std::tolower((unsigned char)b);
+                          });
+    return it != haystack.end();
+}
+
+// Strict ordering for a query; ties fall back to the same secondary keys the
+// app uses, then to PID so the window is stable between ticks.
+static bool row_before(const ProcessListRow& a, const ProcessListRow& b, int key, bool descending) {
+    auto ordered = [descending](auto x, auto y) { return descending ? x > y : x < y; };
+    switch (key) {
+        case kSortCpu:
+            if (a.cpu != b.cpu) return ordered(a.cpu, b.cpu);
+            if (a.ramBytes != b.ramBytes) return ordered(a.ramBytes, b.ramBytes);
+            break;
+        case kSortRam:
+            if (a.ramBytes != b.ramBytes) return ordered(a.ramBytes, b.ramBytes);
+            if (a.cpu != b.cpu) return ordered(a.cpu, b.cpu);
+            break;
+        case kSortName: {
+            int c = a.name->compare(*b.name);
+            if (c != 0) return descending ? c > 0 : c < 0;
+            break;
+        }
+        case kSortNice:
+            if (a.nice != b.nice) return ordered(a.nice, b.nice);
+            break;
+        case kSortPss: {
+            long pa = a.pssBytes >= 0 ? a.pssBytes : a.ramBytes;
+            long pb = b.pssBytes >= 0 ? b.pssBytes : b.ramBytes;
+            if (pa != pb) return ordered(pa, pb);
+            if (a.cpu != b.cpu) return ordered(a.cpu, b.cpu);
+            break;
+        }
+        default:
+            return ordered(a.pid, b.pid);
+    }
+    return a.pid < b.pid;
+}
+
+ProcessListDelta query_process_list(const ProcessSnapshot& snap, const ProcessQuery& query) {
+    ProcessListDelta result;
+    result.generation = snap.generation;
+    result.globalCpu = snap.globalCpu;
+    result.ramUsed = snap.ramUsed;
+    result.ramTotal = snap.ramTotal;
+
+    std::vector<const ProcessListRow*> matches;
+    matches.reserve(snap.rows.size());
+    for (const ProcessListRow& row : snap.rows) {
+        if (query.filter.empty() || contains_ignore_case(*row.name, query.filter)) {
+            matches.push_back(&row);
+        }
+    }
+    result.totalRows = matches.size();
+    if (query.offset >= matches.size()) return result;
+
+    size_t end = matches.size();
+    if (query.limit > 0 && query.limit < end - query.offset) end = query.offset + query.limit;
+    auto before = [&query](const ProcessListRow* a, const ProcessListRow* b) {
+        return row_before(*a, *b, query.sortKey, query.descending);
+    };
+    std::partial_sort(matches.begin(), matches.begin() + end, matches.end(), before);
+
+    result.rows.reserve(end - query.offset);
+    for (size_t i = query.offset; i < end; ++i) result.rows.push_back(*matches[i]);
+    return result;
+}
 
+std::string build_process_list_delta(const ProcessSnapshot& snap, unsigned long long sinceGeneration) {
+    ProcessListDelta delta = collect_process_list_delta(snap, sinceGeneration);
+    std::stringstream ss;
+    ss << "GEN|" << delta.generation << "|" << (delta.full ? "FULL" : "DELTA") << "\n";
+    write_head(ss, delta.globalCpu, delta.ramUsed, delta.ramTotal);
+    for (int pid : delta.removed) ss << "-" << pid << "\n";
+    for (const ProcessListRow& row : delta.rows) write_row(ss, row);
     return ss.str();
 }
+
+void set_process_delta_thresholds(double cpuPercent, long ramBytes) {
+    std::lock_guard<std::mutex> lock(g_scan_mutex);
+    g_delta_cpu_threshold = cpuPercent < 0.0 ? 0.0 : cpuPercent;
+    g_delta_ram_threshold = ramBytes < 0 ? 0 : ramBytes;
+}
+
+void set_pss_collection(bool enabled, long budgetUs) {
+    std::lock_guard<std::mutex> lock(g_scan_mutex);
+    g_pss_enabled = enabled;
+    g_pss_budget_us = budgetUs > 0 ? budgetUs : kDefaultPssBudgetUs;
+}
@@ -1,5 +1,122 @@
 #pragma once
 
+#include <memory>
 #include <string>
+#include <vector>
 
-std::string build_process_list();
+// Generations of removals kept for delta clients; older clients get a full table.
+constexpr unsigned long long kDeltaHistoryGenerations = 120;
+// A row is resent once its CPU share or RSS moves by at least this much.
+constexpr double kDefaultDeltaCpuThreshold = 0.5;
+constexpr long kDefaultDeltaRamThreshold = 1024 * 1024;
+
+struct ProcessListRow {
+    int pid;
+    std::shared_ptr<const std::string> name;
+    long ramBytes;
+    double cpu;
+    long nice;
+    // From smaps_rollup when PSS collection is on; -1 until first read.
+    long pssBytes;
+    long ussBytes;
+    long swapPssBytes;
+};
+
+// One scan's worth of process table, relative to a client's generation.
+struct ProcessListDelta {
+    unsigned long long generation = 0;
+    bool full = true;
+    double globalCpu = 0.0;
+    long ramUsed = 0;
+    long ramTotal = 0;
+    std::vector<ProcessListRow> rows;
+    std::vector<int> removed;
+    // For a windowed query, rows matching the filter before offset/limit.
+    size_t totalRows = 0;
+};
+
+// Sort keys for query_process_list; the values are shared with the app.
+enum ProcessSortKey {
+    kSortCpu = 0,
+    kSortRam = 1,
+    kSortName = 2,
+    kSortPid = 3,
+    kSortNice = 4,
+    kSortPss = 5,   // unknown PSS sorts as RSS
+};
+
+// PSS collection. smaps_rollup walks the whole address space in the kernel,
+// so a process is re-read only once its RSS has moved by kPssRefreshRamBytes,
+// it has taken kPssRefreshFaults page faults, or kPssMaxAgeMs has passed
+// since its last read. Each scan spends at most its budget on reads, unread
+// processes first and then the largest RSS moves; the rest wait for the
+// next scan.
+constexpr long kPssRefreshRamBytes = 1024 * 1024;
+constexpr unsigned long long kPssRefreshFaults = 2048;
+constexpr long long kPssMaxAgeMs = 60000;
+constexpr long kDefaultPssBudgetUs = 5000;
+
+struct ProcessQuery {
+    int sortKey = kSortRam;
+    bool descending = true;
+    std::string filter;  // case-insensitive substring of the name; empty matches all
+    size_t offset = 0;
+    size_t limit = 0;    // 0: no limit
+};
+
+struct PublishedProcess {
+    ProcessListRow row;              // values last sent to delta clients
+    unsigned long long changedGen;   // generation that sent them
+};
+
+struct RemovedPid {
+    unsigned long long generation;
+    int pid;
+};
+
+// Immutable result of one /proc scan. Everything the process list endpoints
+// format comes from here, so a snapshot can be produced on one thread and
+// served from another.
+struct ProcessSnapshot {
+    unsigned long long generation = 0;
+    double globalCpu = 0.0;
+    long ramUsed = 0;
+    long ramTotal = 0;
+    std::vector<ProcessListRow> rows;          // this scan, /proc order, exact values
+    std::vector<PublishedProcess> published;   // every live PID as delta clients see it
+    std::vector<RemovedPid> removed;           // exits within kDeltaHistoryGenerations
+    int processCount = 0;                      // every readable PID, kernel threads included
+    long threadCount = 0;                      // sum of their num_threads
+};
+
+// How old the last scan's totals may be for recent_scan_counts to serve them.
+constexpr long long kScanCountsMaxAgeMs = 2000;
+
+// Process and thread totals from the last scan, so snapshots taken while a
+// scan is running (the sampler, the process list) need not walk /proc again.
+// Returns false when no scan finished within kScanCountsMaxAgeMs.
+bool recent_scan_counts(int& processes, long& threads);
+
+// Scans /proc under a new generation.
+std::shared_ptr<const ProcessSnapshot> scan_process_snapshot();
+
+std::string build_process_list(const ProcessSnapshot& snap);
+
+// The rows added or changed since sinceGeneration plus the PIDs removed since
+// then. full is set (and removed left empty) when sinceGeneration is 0,
+// unknown, from another service instance, or older than
+// kDeltaHistoryGenerations.
+ProcessListDelta collect_process_list_delta(const ProcessSnapshot& snap, unsigned long long sinceGeneration);
+
+// Only the requested window of the filtered, sorted table (full is always
+// set). Only offset + limit rows are ever ordered.
+ProcessListDelta query_process_list(const ProcessSnapshot& snap, const ProcessQuery& query);
+
+// A "GEN|<generation>|FULL" or "GEN|<generation>|DELTA" line, the usual HEAD
+// line, then the rows added or changed since sinceGeneration and a "-<pid>"
+// line per removed PID. sinceGeneration 0 always yields FULL.
+std::string build_process_list_delta(const ProcessSnapshot& snap, unsigned long long sinceGeneration);
+void set_process_delta_thresholds(double cpuPercent, long ramBytes);
+
+// Off by default. budgetUs <= 0 keeps kDefaultPssBudgetUs.
+void set_pss_collection(bool enabled, long budgetUs);
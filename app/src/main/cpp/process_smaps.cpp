@@ -0,0 +1,251 @@
+#include "process_smaps.h"
+#include "proc_reader.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sstream>
+#include <sys/sysmacros.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace {
+
+bool starts_with(std::string_view s, std::string_view prefix) {
+    return s.size() >= prefix.size() && s.compare(0, prefix.size(), prefix) == 0;
+}
+
+bool ends_with(std::string_view s, std::string_view suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool starts_with_any(std::string_view s, std::initializer_list<std::string_view> prefixes) {
+    for (std::string_view p : prefixes) {
+        if (starts_with(s, p)) return true;
+    }
+    return false;
+}
+
+bool parse_hex(std::string_view s, unsigned int& out) {
+    if (s.empty()) return false;
+    unsigned int v = 0;
+    for (char c : s) {
+        if (c >= '0' && c <= '9') v = v * 16 + (unsigned int)(c - '0');
+        else if (c >= 'a' && c <= 'f') v = v * 16 + (unsigned int)(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') v = v * 16 + (unsigned int)(c - 'A' + 10);
+        else return false;
+    }
+    out = v;
+    return true;
+}
+
+// Order matters: dalvik spaces live in ashmem or [anon:], so they are
+// matched before the generic ashmem and anon buckets.
+MemCategory classify_vma(std::string_view name) {
+    if (name.empty()) return kMemOtherAnon;
+    if (starts_with_any(name, {"[anon:dalvik-", "/dev/ashmem/dalvik-"})) return kMemJavaHeap;
+    if (starts_with_any(name, {"[heap]", "[anon:libc_malloc", "[anon:scudo:", "[anon:jemalloc", "[anon:GWP-ASan"})) {
+        return kMemNativeHeap;
+    }
+    if (starts_with_any(name, {"[stack", "[anon:stack_and_tls:", "[anon:thread signal stack"})) return kMemStack;
+    if (starts_with_any(name, {"/dev/kgsl", "/dev/mali", "/dev/dri", "/dev/dma_heap", "/dev/ion", "/dev/nvmap",
+                               "/dev/pvr", "/dmabuf", "anon_inode:dmabuf"})) {
+        return kMemGraphics;
+    }
+    if (starts_with_any(name, {"/dev/ashmem", "/memfd:"})) return kMemAshmem;
+    if (name[0] == '[' || starts_with(name, "anon_inode:")) return kMemOtherAnon;
+
+    constexpr std::string_view kDeleted = " (deleted)";
+    if (ends_with(name, kDeleted)) name.remove_suffix(kDeleted.size());
+    if (ends_with(name, ".so") || name.find(".so.") != std::string_view::npos || ends_with(name, ".oat") ||
+        ends_with(name, ".odex") || ends_with(name, ".vdex")) {
+        return kMemCode;
+    }
+    if (ends_with(name, ".dex") || ends_with(name, ".apk") || ends_with(name, ".jar")) return kMemDex;
+    return kMemOtherMmap;
+}
+
+struct SmapsParser {
+    SmapsBreakdown& out;
+    std::vector<MappedModule>* modules;
+    int pid;
+    std::unordered_map<MappedFileKey, size_t, MappedFileKeyHash> moduleIndex;
+    MemCategory current = kMemOtherAnon;
+    MappedModule* currentModule = nullptr;
+
+    SmapsParser(SmapsBreakdown& out, std::vector<MappedModule>* modules, int pid)
+        : out(out), modules(modules), pid(pid) {}
+
+    void add(unsigned long long MemCategoryTotals::*field, unsigned long long kb) {
+        out.categories[current].*field += kb;
+        out.total.*field += kb;
+    }
+
+    void header(std::string_view line) {
+        std::string_view range = next_token(line);
+        next_token(line);  // perms
+        next_token(line);  // offset
+        std::string_view dev = next_token(line);
+        unsigned long long inode = 0;
+        parse_ull(line, inode);
+        std::string_view name = trim_view(line);
+        current = classify_vma(name);
+        out.vmaCount++;
+
+        currentModule = nullptr;
+        unsigned int major = 0;
+        unsigned int minor = 0;
+        if (!modules || inode == 0 || name.empty() || name[0] != '/' || !parse_dev(dev, major, minor)) return;
+        MappedFileKey key{((unsigned long long)major << 32) | minor, inode};
+        auto it = moduleIndex.find(key);
+        if (it == moduleIndex.end()) {
+            MappedModule m;
+            m.path = std::string(name);
+            m.pid = pid;
+            m.range = std::string(range);
+            m.devMajor = major;
+            m.devMinor = minor;
+            m.inode = inode;
+            it = moduleIndex.emplace(key, modules->size()).first;
+            modules->push_back(std::move(m));
+        }
+        currentModule = &(*modules)[it->second];
+    }
+
+    // A VMA header ("7f00-7f10 r-xp 00000000 fd:01 1234   /path") starts
+    // with a lowercase hex address; field lines start with an uppercase key.
+    void line(std::string_view line) {
+        if (line.empty()) return;
+        char c = line[0];
+        if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f')) {
+            header(line);
+            return;
+        }
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos) return;
+        std::string_view key = line.substr(0, colon);
+        std::string_view rest = line.substr(colon + 1);
+        unsigned long long kb = 0;
+        if (key == "Size") {
+            if (currentModule && parse_ull(rest, kb)) currentModule->sizeKb += kb;
+        } else if (key == "Rss") {
+            if (!parse_ull(rest, kb)) return;
+            add(&MemCategoryTotals::rssKb, kb);
+            if (currentModule) currentModule->rssKb += kb;
+        } else if (key == "Pss") {
+            if (!parse_ull(rest, kb)) return;
+            add(&MemCategoryTotals::pssKb, kb);
+            if (currentModule) currentModule->pssKb += kb;
+        } else if (key == "Private_Dirty") {
+            if (parse_ull(rest, kb)) add(&MemCategoryTotals::privateDirtyKb, kb);
+        } else if (key == "Swap") {
+            if (parse_ull(rest, kb)) add(&MemCategoryTotals::swapKb, kb);
+        }
+    }
+};
+
+void write_totals(std::stringstream& ss, const char* name, const MemCategoryTotals& t) {
+    ss << name << "=" << t.rssKb << ":" << t.pssKb << ":" << t.privateDirtyKb << ":" << t.swapKb;
+}
+
+} // namespace
+
+const char* mem_category_name(MemCategory category) {
+    switch (category) {
+        case kMemJavaHeap: return "JavaHeap";
+        case kMemNativeHeap: return "NativeHeap";
+        case kMemStack: return "Stack";
+        case kMemCode: return "Code";
+        case kMemDex: return "Dex";
+        case kMemGraphics: return "Graphics";
+        case kMemAshmem: return "Ashmem";
+        case kMemOtherMmap: return "OtherMmap";
+        default: return "OtherAnon";
+    }
+}
+
+bool is_module_file(std::string_view path) {
+    for (std::string_view ext : {".so", ".apk", ".dex", ".oat", ".jar", ".ttf"}) {
+        if (path.find(ext) != std::string_view::npos) return true;
+    }
+    return false;
+}
+
+bool parse_dev(std::string_view dev, unsigned int& major, unsigned int& minor) {
+    size_t colon = dev.find(':');
+    if (colon == std::string_view::npos) return false;
+    return parse_hex(dev.substr(0, colon), major) && parse_hex(dev.substr(colon + 1), minor);
+}
+
+int open_mapped_file(const MappedModule& m, struct stat& st) {
+    // maps pads addresses to 8 digits; map_files names are unpadded.
+    unsigned long long start = 0;
+    unsigned long long end = 0;
+    char mapFile[96] = "";
+    if (sscanf(m.range.c_str(), "%llx-%llx", &start, &end) == 2) {
+        snprintf(mapFile, sizeof(mapFile), "/proc/%d/map_files/%llx-%llx", m.pid, start, end);
+    }
+    std::string candidates[] = {
+        mapFile,
+        "/proc/" + std::to_string(m.pid) + "/root" + m.path,
+    };
+    for (const std::string& path : candidates) {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) continue;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_ino == m.inode && major(st.st_dev) == m.devMajor &&
+            minor(st.st_dev) == m.devMinor) {
+            return fd;
+        }
+        close(fd);
+    }
+    return -1;
+}
+
+bool read_smaps_breakdown(int pid, SmapsBreakdown& out, std::vector<MappedModule>* modules) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/smaps", pid);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    SmapsParser parser(out, modules, pid);
+    char buf[kSmapsChunkSize];
+    size_t have = 0;
+    bool skipping = false;  // dropping the tail of an over-long line
+    for (;;) {
+        ssize_t n = read(fd, buf + have, sizeof(buf) - have);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        have += (size_t)n;
+
+        size_t start = 0;
+        while (const char* nl = (const char*)memchr(buf + start, '\n', have - start)) {
+            size_t end = (size_t)(nl - buf);
+            if (!skipping) parser.line(std::string_view(buf + start, end - start));
+            skipping = false;
+            start = end + 1;
+        }
+        if (start == 0 && have == sizeof(buf)) {
+            if (!skipping) parser.line(std::string_view(buf, have));
+            skipping = true;
+            have = 0;
+            continue;
+        }
+        memmove(buf, buf + start, have - start);
+        have -= start;
+    }
+    if (have > 0 && !skipping) parser.line(std::string_view(buf, have));
+    close(fd);
+    return true;
+}
+
+std::string format_smaps_breakdown(const SmapsBreakdown& breakdown) {
+    if (breakdown.vmaCount == 0) return "";
+    std::stringstream ss;
+    for (int i = 0; i < kMemCategoryCount; ++i) {
+        write_totals(ss, mem_category_name((MemCategory)i), breakdown.categories[i]);
+        ss << "|";
+    }
+    write_totals(ss, "Total", breakdown.total);
+    return ss.str();
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <sys/stat.h>
+#include <vector>
+
+// dumpsys-meminfo style buckets for the VMAs of one process.
+enum MemCategory {
+    kMemJavaHeap = 0,   // dalvik-* spaces
+    kMemNativeHeap,     // [heap], libc_malloc, scudo, jemalloc
+    kMemStack,          // [stack], thread stacks
+    kMemCode,           // .so, .oat, .odex, .vdex
+    kMemDex,            // .dex, .apk, .jar
+    kMemGraphics,       // GPU driver nodes and dma-bufs
+    kMemAshmem,         // ashmem and memfd
+    kMemOtherMmap,      // any other file or device mapping
+    kMemOtherAnon,      // unnamed and other [anon:...] memory
+    kMemCategoryCount
+};
+
+struct MemCategoryTotals {
+    unsigned long long rssKb = 0;
+    unsigned long long pssKb = 0;
+    unsigned long long privateDirtyKb = 0;
+    unsigned long long swapKb = 0;
+};
+
+struct SmapsBreakdown {
+    MemCategoryTotals categories[kMemCategoryCount];
+    MemCategoryTotals total;
+    size_t vmaCount = 0;
+};
+
+// A mapped file's identity as /proc/<pid>/maps reports it; stable across
+// processes, unlike a path that may be replaced after mapping.
+struct MappedFileKey {
+    unsigned long long dev = 0;   // major << 32 | minor
+    unsigned long long inode = 0;
+    bool operator==(const MappedFileKey& o) const { return dev == o.dev && inode == o.inode; }
+};
+
+struct MappedFileKeyHash {
+    size_t operator()(const MappedFileKey& k) const { return std::hash<unsigned long long>()(k.dev * 31 + k.inode); }
+};
+
+// Every VMA of one mapped file (same device and inode), summed.
+struct MappedModule {
+    std::string path;
+    int pid = 0;                     // with range, one mapping to open it through
+    std::string range;               // "7f00-7f10" of the first VMA
+    unsigned int devMajor = 0;
+    unsigned int devMinor = 0;
+    unsigned long long inode = 0;
+    unsigned long long sizeKb = 0;   // address space mapped
+    unsigned long long rssKb = 0;
+    unsigned long long pssKb = 0;
+
+    MappedFileKey key() const { return {((unsigned long long)devMajor << 32) | devMinor, inode}; }
+};
+
+// smaps is read through one buffer of this size; a line longer than it
+// (only possible for a very long path) is classified by its first part.
+constexpr size_t kSmapsChunkSize = 16384;
+
+const char* mem_category_name(MemCategory category);
+
+// .so/.apk/.dex/.oat/.jar/.ttf: the files the Modules list shows.
+bool is_module_file(std::string_view path);
+
+// "fd:01" -> 0xfd, 0x01
+bool parse_dev(std::string_view dev, unsigned int& major, unsigned int& minor);
+
+// Opens the file behind one mapping of m.pid, read-only: through
+// /proc/<pid>/map_files/<range> (the very file mapped; needs CAP_SYS_ADMIN),
+// else the path inside the process's mount namespace via /proc/<pid>/root.
+// Returns -1 unless the opened file's device and inode are m.key(), so a
+// path replaced after mapping or resolved in another namespace is never
+// measured in its place. st is filled on success.
+int open_mapped_file(const MappedModule& m, struct stat& st);
+
+// Streams /proc/<pid>/smaps, classifying each VMA by its name and, when
+// modules is given, summing file-backed VMAs per (device, inode) in /proc
+// order of first mapping. Returns false when the file cannot be opened.
+bool read_smaps_breakdown(int pid, SmapsBreakdown& out, std::vector<MappedModule>* modules = nullptr);
+
+// "JavaHeap=rss:pss:privateDirty:swap|...|Total=..." in kB, for the deep
+// snapshot's MEMORY section. Empty when no VMA was read.
+std::string format_smaps_breakdown(const SmapsBreakdown& breakdown);
@@ -0,0 +1,61 @@
+#include "process_table.h"
+
+#include <cstring>
+
+namespace {
+
+// Android ABIs are all little-endian, so values are copied as-is.
+template <typename T>
+uint8_t* put(uint8_t* p, T value) {
+    std::memcpy(p, &value, sizeof(T));
+    return p + sizeof(T);
+}
+
+} // namespace
+
+std::vector<uint8_t> encode_process_table(const ProcessListDelta& delta) {
+    const size_t n = delta.rows.size();
+    const size_t m = delta.removed.size();
+    size_t blobSize = 0;
+    for (const ProcessListRow& row : delta.rows) blobSize += row.name->size();
+
+    size_t total = kProcessTableHeaderSize +
+                   n * (4 * sizeof(int64_t) + sizeof(double) + 2 * sizeof(int32_t)) +
+                   (n + 1) * sizeof(uint32_t) + m * sizeof(int32_t) + blobSize;
+    std::vector<uint8_t> out(total);
+    uint8_t* p = out.data();
+
+    p = put<uint32_t>(p, kProcessTableMagic);
+    p = put<uint16_t>(p, kProcessTableVersion);
+    p = put<uint16_t>(p, delta.full ? 0 : kProcessTableFlagDelta);
+    p = put<uint64_t>(p, delta.generation);
+    p = put<double>(p, delta.globalCpu);
+    p = put<int64_t>(p, delta.ramUsed);
+    p = put<int64_t>(p, delta.ramTotal);
+    p = put<uint32_t>(p, (uint32_t)n);
+    p = put<uint32_t>(p, (uint32_t)m);
+    p = put<uint32_t>(p, (uint32_t)blobSize);
+    p = put<uint32_t>(p, (uint32_t)delta.totalRows);
+
+    for (const ProcessListRow& row : delta.rows) p = put<int64_t>(p, row.ramBytes);
+    for (const ProcessListRow& row : delta.rows) p = put<double>(p, row.cpu);
+    for (const ProcessListRow& row : delta.rows) p = put<int64_t>(p, row.pssBytes);
+    for (const ProcessListRow& row : delta.rows) p = put<int64_t>(p, row.ussBytes);
+    for (const ProcessListRow& row : delta.rows) p = put<int64_t>(p, row.swapPssBytes);
+    for (const ProcessListRow& row : delta.rows) p = put<int32_t>(p, row.pid);
+    for (const ProcessListRow& row : delta.rows) p = put<int32_t>(p, (int32_t)row.nice);
+
+    uint32_t offset = 0;
+    for (const ProcessListRow& row : delta.rows) {
+        p = put<uint32_t>(p, offset);
+        offset += (uint32_t)row.name->size();
+    }
+    p = put<uint32_t>(p, offset);
+
+    for (int pid : delta.removed) p = put<int32_t>(p, pid);
+    for (const ProcessListRow& row : delta.rows) {
+        std::memcpy(p, row.name->data(), row.name->size());
+        p += row.name->size();
+    }
+    return out;
+}
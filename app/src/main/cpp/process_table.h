@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "process_scan.h"
+
+// Binary process table, version 3. All fields little-endian.
+//
+//   off  size  field
+//     0     4  magic 'PTAB' (0x42415450)
+//     4     2  version
+//     6     2  flags (bit 0: delta, rows/removed are relative to a generation)
+//     8     8  generation
+//    16     8  global CPU % (f64)
+//    24     8  RAM used bytes (i64)
+//    32     8  RAM total bytes (i64)
+//    40     4  row count n
+//    44     4  removed count m
+//    48     4  name blob size in bytes
+//    52     4  rows matching a windowed query before offset/limit
+//              (v2; 0 in v1 and for delta tables)
+//    56        i64 ramBytes[n], f64 cpu[n],
+//              i64 pssBytes[n], i64 ussBytes[n], i64 swapPssBytes[n] (v3;
+//              -1 where not collected),
+//              i32 pid[n], i32 nice[n], u32 nameOffset[n + 1],
+//              i32 removedPid[m], UTF-8 name blob
+//
+// Row i's name is blob[nameOffset[i], nameOffset[i + 1]). The 8-byte columns
+// come first, so every column is naturally aligned.
+constexpr uint32_t kProcessTableMagic = 0x42415450;
+constexpr uint16_t kProcessTableVersion = 3;
+constexpr uint16_t kProcessTableFlagDelta = 1;
+constexpr size_t kProcessTableHeaderSize = 56;
+
+std::vector<uint8_t> encode_process_table(const ProcessListDelta& delta);
@@ -0,0 +1,270 @@
+#include "psi.h"
+#include "native_common.h"
+#include "proc_reader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <fcntl.h>
+#include <mutex>
+#include <poll.h>
+#include <sstream>
+#include <sys/eventfd.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const char* const kPsiPaths[] = {"/proc/pressure/cpu", "/proc/pressure/memory", "/proc/pressure/io"};
+const char* const kPsiNames[] = {"cpu", "memory", "io"};
+
+struct PsiTrigger {
+    int id;
+    PsiResourceKind kind;
+    bool full;
+    long stallUs;
+    long windowUs;
+    int fd;
+};
+
+struct PsiEvent {
+    unsigned long long seq;
+    int triggerId;
+    PsiResourceKind kind;
+    bool full;
+    long long timeMs;
+};
+
+struct PsiState {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<PsiTrigger> triggers;
+    // Descriptors of removed triggers, closed by the watcher once it is out
+    // of poll() so a recycled fd number is never polled by mistake.
+    std::vector<int> closing;
+    std::deque<PsiEvent> events;
+    unsigned long long seq = 0;
+    int nextId = 1;
+    int wakeFd = -1;
+    bool threadStarted = false;
+};
+
+// Leaked on purpose: the watcher thread is detached and may outlive statics.
+PsiState& psi_state() {
+    static PsiState* state = new PsiState();
+    return *state;
+}
+
+long long now_ms() {
+    struct timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000LL;
+}
+
+// "some avg10=0.12 avg60=0.05 avg300=0.01 total=123456"
+void parse_psi_fields(std::string_view line, PsiLine& out) {
+    while (!line.empty()) {
+        std::string_view token = next_token(line);
+        if (token.empty()) break;
+        size_t eq = token.find('=');
+        if (eq == std::string_view::npos) continue;
+        std::string_view key = token.substr(0, eq);
+        std::string value(token.substr(eq + 1));
+        if (key == "avg10") {
+            out.avg10 = std::strtod(value.c_str(), nullptr);
+        } else if (key == "avg60") {
+            out.avg60 = std::strtod(value.c_str(), nullptr);
+        } else if (key == "avg300") {
+            out.avg300 = std::strtod(value.c_str(), nullptr);
+        } else if (key == "total") {
+            out.totalUs = std::strtoull(value.c_str(), nullptr, 10);
+        }
+    }
+    out.valid = true;
+}
+
+void write_psi_line(std::stringstream& ss, const PsiLine& line) {
+    if (!line.valid) {
+        ss << "null";
+        return;
+    }
+    ss << "{\"avg10\":" << line.avg10 << ",\"avg60\":" << line.avg60 << ",\"avg300\":" << line.avg300
+       << ",\"totalUs\":" << line.totalUs << "}";
+}
+
+void psi_watch_loop() {
+    PsiState& g = psi_state();
+    std::vector<pollfd> fds;
+    std::vector<PsiTrigger> polled;
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(g.mutex);
+            for (int fd : g.closing) close(fd);
+            g.closing.clear();
+            polled = g.triggers;
+        }
+        fds.assign(1, pollfd{g.wakeFd, POLLIN, 0});
+        for (const PsiTrigger& t : polled) fds.push_back({t.fd, POLLPRI, 0});
+
+        int ready = poll(fds.data(), fds.size(), -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            LOGE("PSI watcher poll failed (errno=%d)", errno);
+            return;
+        }
+        if (fds[0].revents & POLLIN) {
+            eventfd_t drained;
+            eventfd_read(g.wakeFd, &drained);
+        }
+
+        std::lock_guard<std::mutex> lock(g.mutex);
+        long long now = now_ms();
+        bool fired = false;
+        for (size_t i = 1; i < fds.size(); ++i) {
+            const PsiTrigger& t = polled[i - 1];
+            bool stillRegistered = std::any_of(g.triggers.begin(), g.triggers.end(),
+                                               [&t](const PsiTrigger& x) { return x.id == t.id; });
+            if (!stillRegistered) continue;
+            if (fds[i].revents & POLLERR) {
+                // The kernel tore the trigger down; stop polling it.
+                LOGE("PSI trigger %d on %s failed, dropping it", t.id, kPsiNames[t.kind]);
+                g.triggers.erase(std::remove_if(g.triggers.begin(), g.triggers.end(),
+                                                [&t](const PsiTrigger& x) { return x.id == t.id; }),
+                                 g.triggers.end());
+                g.closing.push_back(t.fd);
+                continue;
+            }
+            if (!(fds[i].revents & POLLPRI)) continue;
+            g.events.push_back({++g.seq, t.id, t.kind, t.full, now});
+            while (g.events.size() > kPsiEventHistory) g.events.pop_front();
+            fired = true;
+        }
+        if (fired) g.cv.notify_all();
+    }
+}
+
+bool ensure_watcher_locked(PsiState& g) {
+    if (g.threadStarted) return true;
+    g.wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (g.wakeFd < 0) {
+        LOGE("PSI watcher eventfd failed (errno=%d)", errno);
+        return false;
+    }
+    std::thread(psi_watch_loop).detach();
+    g.threadStarted = true;
+    return true;
+}
+
+} // namespace
+
+bool read_psi(PsiResourceKind kind, PsiResource& out) {
+    std::string_view content = cached_read_view(kPsiPaths[kind]);
+    if (content.empty()) return false;
+    while (!content.empty()) {
+        std::string_view line = next_line(content);
+        std::string_view which = next_token(line);
+        if (which == "some") {
+            parse_psi_fields(line, out.some);
+        } else if (which == "full") {
+            parse_psi_fields(line, out.full);
+        }
+    }
+    return out.some.valid;
+}
+
+std::string psi_resource_json(PsiResourceKind kind) {
+    PsiResource res;
+    if (!read_psi(kind, res)) return "null";
+    std::stringstream ss;
+    ss << "{\"some\":";
+    write_psi_line(ss, res.some);
+    ss << ",\"full\":";
+    write_psi_line(ss, res.full);
+    ss << "}";
+    return ss.str();
+}
+
+std::string get_psi_snapshot_json() {
+    std::stringstream ss;
+    ss << "{";
+    ss << "\"cpu\":" << psi_resource_json(kPsiCpu) << ",";
+    ss << "\"memory\":" << psi_resource_json(kPsiMemory) << ",";
+    ss << "\"io\":" << psi_resource_json(kPsiIo);
+    ss << "}";
+    return ss.str();
+}
+
+int psi_add_trigger(PsiResourceKind kind, bool full, long stallUs, long windowUs) {
+    if (kind < kPsiCpu || kind > kPsiIo || stallUs <= 0 || windowUs <= 0 || stallUs > windowUs) return -1;
+    int fd = open(kPsiPaths[kind], O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        LOGE("PSI %s unavailable (errno=%d)", kPsiNames[kind], errno);
+        return -1;
+    }
+    std::string spec = std::string(full ? "full " : "some ") + std::to_string(stallUs) + " " + std::to_string(windowUs);
+    // The trigger string must be written NUL-terminated in a single write.
+    if (write(fd, spec.c_str(), spec.size() + 1) < 0) {
+        LOGE("PSI trigger \"%s\" on %s rejected (errno=%d)", spec.c_str(), kPsiNames[kind], errno);
+        close(fd);
+        return -1;
+    }
+
+    PsiState& g = psi_state();
+    std::lock_guard<std::mutex> lock(g.mutex);
+    if (!ensure_watcher_locked(g)) {
+        close(fd);
+        return -1;
+    }
+    int id = g.nextId++;
+    g.triggers.push_back({id, kind, full, stallUs, windowUs, fd});
+    eventfd_write(g.wakeFd, 1);
+    return id;
+}
+
+void psi_remove_trigger(int id) {
+    PsiState& g = psi_state();
+    std::lock_guard<std::mutex> lock(g.mutex);
+    auto it = std::find_if(g.triggers.begin(), g.triggers.end(), [id](const PsiTrigger& t) { return t.id == id; });
+    if (it == g.triggers.end()) return;
+    g.closing.push_back(it->fd);
+    g.triggers.erase(it);
+    eventfd_write(g.wakeFd, 1);
+}
+
+bool psi_trigger_active(int id) {
+    PsiState& g = psi_state();
+    std::lock_guard<std::mutex> lock(g.mutex);
+    return std::any_of(g.triggers.begin(), g.triggers.end(), [id](const PsiTrigger& t) { return t.id == id; });
+}
+
+std::string psi_wait_events_json(unsigned long long sinceSeq, long timeoutMs) {
+    PsiState& g = psi_state();
+    long waitMs = std::min(std::max(timeoutMs, 0L), kPsiMaxWaitMs);
+    std::unique_lock<std::mutex> lock(g.mutex);
+    // A sinceSeq ahead of ours is from before a service restart; answer at once.
+    if (sinceSeq <= g.seq) {
+        g.cv.wait_for(lock, std::chrono::milliseconds(waitMs), [&g, sinceSeq] { return g.seq > sinceSeq; });
+    }
+
+    std::stringstream ss;
+    ss << "{";
+    ss << "\"seq\":" << g.seq << ",";
+    ss << "\"events\":[";
+    bool first = true;
+    for (const PsiEvent& e : g.events) {
+        if (e.seq <= sinceSeq) continue;
+        if (!first) ss << ",";
+        first = false;
+        ss << "{\"seq\":" << e.seq << ",\"trigger\":" << e.triggerId << ",\"resource\":\"" << kPsiNames[e.kind]
+           << "\",\"full\":" << (e.full ? "true" : "false") << ",\"timestampMs\":" << e.timeMs << "}";
+    }
+    ss << "]";
+    ss << "}";
+    return ss.str();
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+
+enum PsiResourceKind {
+    kPsiCpu = 0,
+    kPsiMemory,
+    kPsiIo
+};
+
+// One "some" or "full" line of /proc/pressure/<resource>.
+struct PsiLine {
+    bool valid = false;
+    double avg10 = 0.0;
+    double avg60 = 0.0;
+    double avg300 = 0.0;
+    unsigned long long totalUs = 0;
+};
+
+struct PsiResource {
+    PsiLine some;
+    PsiLine full;
+};
+
+// False when the kernel has no PSI (CONFIG_PSI off or psi=0).
+bool read_psi(PsiResourceKind kind, PsiResource& out);
+
+// {"some":{...},"full":{...}} for one resource, or null without PSI.
+std::string psi_resource_json(PsiResourceKind kind);
+
+// cpu, memory and io in one object.
+std::string get_psi_snapshot_json();
+
+// Kernel triggers: the kernel wakes the watcher thread (POLLPRI) when
+// "some"/"full" stall time exceeds stallUs within any windowUs window, so
+// nothing polls counters while the system is healthy. windowUs must be
+// 500 ms .. 10 s. Returns a trigger id, or -1 when PSI or the trigger is
+// unavailable.
+int psi_add_trigger(PsiResourceKind kind, bool full, long stallUs, long windowUs);
+void psi_remove_trigger(int id);
+// False once the trigger is removed or the watcher dropped it after POLLERR.
+bool psi_trigger_active(int id);
+
+// Events the watcher keeps for psi_wait_events_json.
+constexpr size_t kPsiEventHistory = 64;
+// Upper bound on how long one wait may hold its caller, a binder thread when
+// the call comes from a client.
+constexpr long kPsiMaxWaitMs = 2000;
+
+// Blocks until a trigger event newer than sinceSeq exists or timeoutMs
+// passes, then returns {"seq":N,"events":[...]} with every retained event
+// newer than sinceSeq.
+std::string psi_wait_events_json(unsigned long long sinceSeq, long timeoutMs);
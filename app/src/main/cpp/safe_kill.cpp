@@ -2,58 +2,64 @@
 #include "native_utils.h"
 #include "process_detail.h"
 #include "system_stats.h"
+#include "proc_reader.h"
+#include "batch_reader.h"
+#include "process_identity.h"
+#include "psi.h"
 
-#include <fstream>
-#include <dirent.h>
 #include <set>
+#include <vector>
 #include <unordered_set>
 #include <sstream>
 #include <unistd.h>
 #include <cstdlib>
-
-int get_oom_score_adj(const std::string& pid) {
-    std::ifstream oomFile("/proc/" + pid + "/oom_score_adj");
-    int score;
-    if (oomFile >> score) return score;
-    return -1000;
-}
-
-int get_uid_int(const std::string& pid) {
-    std::string uid_full = get_status_field(pid, "Uid:");
-    if (uid_full.empty()) return -1;
-    try {
-        size_t end = uid_full.find_first_of(" \t");
-        return std::stoi(uid_full.substr(0, end));
-    } catch (...) {
-        return -1;
-    }
+#include <mutex>
+
+int arm_kill_pressure_trigger() {
+    static std::mutex mutex;
+    static int triggerId = -1;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (triggerId < 0 || !psi_trigger_active(triggerId)) triggerId = psi_add_trigger(kPsiMemory, false, kKillPressureStallUs, kKillPressureWindowUs);
+    return triggerId;
 }
 
 std::string get_kill_candidates() {
-    DIR* procDir = opendir("/proc");
-    if (procDir == nullptr) return "";
+    std::vector<int> pids = list_proc_pids();
+    if (pids.empty()) return "";
+
+    // stat and oom_score_adj for every PID in one batch; UID and name come
+    // from the identity cache.
+    std::vector<BatchRead> reads(pids.size() * 2);
+    for (size_t i = 0; i < pids.size(); ++i) {
+        std::string base = "/proc/" + std::to_string(pids[i]);
+        reads[2 * i].path = base + "/stat";
+        reads[2 * i + 1].path = base + "/oom_score_adj";
+        reads[2 * i + 1].cap = 64;
+    }
+    batch_read(reads);
+
+    std::vector<IdentityRequest> apps;
+    for (size_t i = 0; i < pids.size(); ++i) {
+        ProcStat st;
+        const BatchRead& stat = reads[2 * i];
+        if (!stat.ok() || !parse_proc_stat(stat.data, (size_t)stat.size, st)) continue;
+        // Kernel threads have no RSS and are never candidates.
+        if (st.rss <= 0) continue;
+        std::string_view adjText = reads[2 * i + 1].view();
+        long long oom_adj = -1000;
+        if (!parse_ll(adjText, oom_adj) || oom_adj < 100) continue;
+        apps.push_back({pids[i], st.starttime, st.ppid});
+    }
 
+    std::vector<ProcessIdentity> identities = resolve_process_identities(apps);
     std::set<std::string> candidates;
-
-    struct dirent* entry;
-    while ((entry = readdir(procDir)) != nullptr) {
-        if (entry->d_type == DT_DIR) {
-            std::string pid_str = entry->d_name;
-            if (pid_str.find_first_not_of("0123456789") == std::string::npos) {
-                int uid = get_uid_int(pid_str);
-                if (uid >= 10000) {
-                    int oom_adj = get_oom_score_adj(pid_str);
-                    if (oom_adj >= 100) {
-                        std::string name = getProcessName(pid_str);
-                        if (!name.empty() && name != "Unknown" && name != "sh" && name != "su") {
-                            candidates.insert(name);
-                        }
-                    }
-                }
-            }
+    for (const ProcessIdentity& id : identities) {
+        if (id.uid < 10000) continue;
+        const std::string& name = *id.name;
+        if (!name.empty() && name != "Unknown" && name != "sh" && name != "su") {
+            candidates.insert(name);
         }
     }
-    closedir(procDir);
 
     std::string recentsOut = execute_shell_command("su -c \"dumpsys activity recents\"");
     std::stringstream rss(recentsOut);
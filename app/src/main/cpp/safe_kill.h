@@ -3,5 +3,16 @@
 #include <string>
 #include <vector>
 
+// Memory stall that arms the kill flow: "some" stall of 150 ms within 1 s,
+// the level at which LMK kills usually follow.
+constexpr long kKillPressureStallUs = 150000;
+constexpr long kKillPressureWindowUs = 1000000;
+
+// Registers the kill-flow memory PSI trigger and returns its id, or -1
+// without PSI. The trigger is shared; it is registered again when it was
+// removed or the watcher dropped it. Its events arrive through
+// psi_wait_events_json.
+int arm_kill_pressure_trigger();
+
 std::string get_kill_candidates();
 long execute_kill_transaction(const std::string& packages);
@@ -0,0 +1,150 @@
+#include "sampler.h"
+#include "native_common.h"
+#include "battery_stats.h"
+#include "cpu_stats.h"
+#include "disk_stats.h"
+#include "gpu_stats.h"
+#include "memory_stats.h"
+#include "net_stats.h"
+#include "performance_mini.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct SamplerConsumer {
+    long intervalMs = 0;
+    unsigned collectors = 0;
+};
+
+// Heap-allocated and never freed for the same reason as the worker pool: the
+// thread is detached and may still be waiting when static destructors run.
+struct SamplerState {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool threadStarted = false;
+    std::map<int, SamplerConsumer> consumers;
+    int nextConsumerId = 1;
+    long intervalMs = 0;            // 0: stopped
+    unsigned collectors = 0;        // union over consumers
+    unsigned long long epoch = 0;   // bumped whenever intervalMs or collectors change
+    std::shared_ptr<const SamplerSnapshot> latest;
+};
+
+SamplerState& state() {
+    static SamplerState* s = new SamplerState();
+    return *s;
+}
+
+long long now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now().time_since_epoch()).count();
+}
+
+std::shared_ptr<const SamplerSnapshot> collect_snapshot(unsigned collectors) {
+    auto snap = std::make_shared<SamplerSnapshot>();
+    snap->collectors = collectors;
+    if (collectors & kSampleProcesses) snap->processes = scan_process_snapshot();
+    if (collectors & kSampleCpu) snap->cpuJson = get_cpu_snapshot_json();
+    if (collectors & kSampleGpu) snap->gpuJson = get_gpu_snapshot_json();
+    if (collectors & kSampleMemory) snap->memoryJson = get_memory_snapshot_json();
+    if (collectors & kSampleDisk) snap->diskJson = get_disk_snapshot_json();
+    if (collectors & kSampleNet) snap->netJson = get_net_snapshot_json();
+    if (collectors & kSamplePerformanceMini) snap->performanceMiniJson = get_performance_mini_snapshot_json();
+    if (collectors & kSampleBattery) snap->batteryJson = get_battery_snapshot_json();
+    snap->takenAtMs = now_ms();
+    return snap;
+}
+
+// Recomputes the schedule from the consumers. A change restarts the loop and
+// drops the published snapshot, so nothing a consumer no longer asks for is
+// served stale. Caller holds s.mutex.
+void apply_consumers_locked(SamplerState& s) {
+    long intervalMs = 0;
+    unsigned collectors = 0;
+    for (const auto& entry : s.consumers) {
+        const SamplerConsumer& c = entry.second;
+        if (intervalMs == 0 || c.intervalMs < intervalMs) intervalMs = c.intervalMs;
+        collectors |= c.collectors;
+    }
+    if (intervalMs == s.intervalMs && collectors == s.collectors) return;
+    s.intervalMs = intervalMs;
+    s.collectors = collectors;
+    ++s.epoch;
+    std::atomic_store(&s.latest, std::shared_ptr<const SamplerSnapshot>());
+    s.cv.notify_all();
+}
+
+void sampler_main() {
+    SamplerState& s = state();
+    std::unique_lock<std::mutex> lock(s.mutex);
+    while (true) {
+        s.cv.wait(lock, [&] { return s.intervalMs > 0; });
+        unsigned long long epoch = s.epoch;
+        unsigned collectors = s.collectors;
+        auto interval = std::chrono::milliseconds(s.intervalMs);
+        auto deadline = Clock::now();
+
+        while (s.epoch == epoch) {
+            lock.unlock();
+            std::shared_ptr<const SamplerSnapshot> snap = collect_snapshot(collectors);
+            lock.lock();
+            if (s.epoch != epoch) break;
+            std::atomic_store(&s.latest, snap);
+
+            deadline += interval;
+            // An overrun tick starts the next one right away rather than
+            // firing a burst to catch up.
+            auto now = Clock::now();
+            if (deadline < now) deadline = now;
+            s.cv.wait_until(lock, deadline, [&] { return s.epoch != epoch; });
+        }
+    }
+}
+
+} // namespace
+
+int start_sampler(long intervalMs, unsigned collectors) {
+    collectors &= kSampleAll;
+    if (collectors == 0) return -1;
+    if (intervalMs < kSamplerMinIntervalMs) intervalMs = kSamplerMinIntervalMs;
+    SamplerState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (!s.threadStarted) {
+        try {
+            std::thread(sampler_main).detach();
+        } catch (const std::exception& e) {
+            LOGE("Failed to start sampler thread: %s", e.what());
+            return -1;
+        }
+        s.threadStarted = true;
+    }
+    int id = s.nextConsumerId++;
+    s.consumers[id] = {intervalMs, collectors};
+    apply_consumers_locked(s);
+    LOGD("Sampler consumer %d: collectors 0x%x every %ld ms", id, collectors, intervalMs);
+    return id;
+}
+
+void stop_sampler(int consumerId) {
+    SamplerState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (s.consumers.erase(consumerId) == 0) return;
+    apply_consumers_locked(s);
+}
+
+std::shared_ptr<const SamplerSnapshot> sampler_latest() {
+    return std::atomic_load(&state().latest);
+}
+
+std::shared_ptr<const ProcessSnapshot> latest_process_snapshot() {
+    std::shared_ptr<const SamplerSnapshot> snap = sampler_latest();
+    if (snap && snap->processes) return snap->processes;
+    return scan_process_snapshot();
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "process_scan.h"
+
+// Collectors a consumer can ask the sampler to run, as a bitmask.
+enum SamplerCollector : unsigned {
+    kSampleProcesses = 1u << 0,
+    kSampleCpu = 1u << 1,
+    kSampleGpu = 1u << 2,
+    kSampleMemory = 1u << 3,
+    kSampleDisk = 1u << 4,
+    kSampleNet = 1u << 5,
+    kSamplePerformanceMini = 1u << 6,
+    kSampleBattery = 1u << 7,
+};
+constexpr unsigned kSampleAll = 0xffu;
+
+// What the sampler collected in one tick; fields outside collectors are left
+// empty. Published whole and never modified afterwards.
+struct SamplerSnapshot {
+    long long takenAtMs = 0;
+    unsigned collectors = 0;
+    std::shared_ptr<const ProcessSnapshot> processes;
+    std::string cpuJson;
+    std::string gpuJson;
+    std::string memoryJson;
+    std::string diskJson;
+    std::string netJson;
+    std::string performanceMiniJson;
+    std::string batteryJson;
+};
+
+constexpr long kSamplerMinIntervalMs = 250;
+
+// Opt-in background sampler. Each consumer registers the collectors it reads;
+// while any are registered, one thread runs the union of them at the
+// shortest requested interval (ticks are spaced from the previous deadline,
+// not from when collection finished) and getters copy out the latest
+// snapshot instead of touching /proc on the caller's thread.
+// Returns a consumer id for stop_sampler, or -1.
+int start_sampler(long intervalMs, unsigned collectors);
+// Drops one consumer; the thread idles once none are left.
+void stop_sampler(int consumerId);
+
+// Latest published snapshot, or null when the sampler is stopped or has not
+// finished its first tick since its collectors changed. Readers never block
+// the sampler.
+std::shared_ptr<const SamplerSnapshot> sampler_latest();
+
+// The sampler's process snapshot when available, otherwise a fresh scan.
+std::shared_ptr<const ProcessSnapshot> latest_process_snapshot();
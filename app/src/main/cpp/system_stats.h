@@ -2,9 +2,6 @@
 
 #include <string>
 
-unsigned long long get_total_system_ticks();
-double getGlobalCpuUsage();
-
 struct RamInfo {
     long total;
     long used;
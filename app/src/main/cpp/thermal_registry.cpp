@@ -0,0 +1,266 @@
+#include "thermal_registry.h"
+#include "native_common.h"
+#include "native_utils.h"
+#include "proc_reader.h"
+
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/netlink.h>
+#include <mutex>
+#include <sstream>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+std::mutex g_thermal_mutex;
+std::shared_ptr<const ThermalRegistry> g_thermal_registry;
+unsigned long long g_thermal_generation = 0;
+long long g_thermal_rescan_at_ms = 0;
+int g_uevent_fd = -1;
+bool g_uevent_opened = false;
+
+const std::vector<std::string> kCpuInclude = {"cpu", "cpullc", "qmx", "apss", "tsens", "soc", "cluster", "big",
+                                              "little", "gold", "prime", "qcom", "msm", "sdm"};
+const std::vector<std::string> kCpuExclude = {"battery", "skin", "usb", "charger", "pmic"};
+const std::vector<std::string> kCpuHwmonNames = {"tsens", "cpu", "soc", "apss", "qcom", "msm", "sdm"};
+
+long long now_ms() {
+    struct timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000LL;
+}
+
+// Exclusions win, then the same precedence get_cpu_temp_c buckets by.
+ThermalClass classify(const std::string& lower) {
+    if (lower.find("battery") != std::string::npos) return kThermalBattery;
+    if (lower.find("skin") != std::string::npos) return kThermalSkin;
+    if (contains_any(lower, kCpuExclude)) return kThermalOther;
+    if (contains_any(lower, {"cpu", "cpullc", "qmx"})) return kThermalCpu;
+    if (contains_any(lower, {"apss", "tsens"})) return kThermalApss;
+    if (lower.find("soc") != std::string::npos) return kThermalSoc;
+    if (lower.find("gpu") != std::string::npos) return kThermalGpu;
+    return kThermalOther;
+}
+
+void add_sensor(ThermalRegistry& reg, bool hwmon, const std::string& type, const std::string& tempPath,
+                const std::string& classifyBy, bool cpuCandidate) {
+    int fd = open(tempPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    ThermalSensor s;
+    s.hwmon = hwmon;
+    s.type = type;
+    s.typeLower = to_lower(type);
+    s.tempPath = tempPath;
+    s.cls = classify(to_lower(classifyBy));
+    s.cpuCandidate = cpuCandidate;
+    s.fd = fd;
+    reg.sensors.push_back(std::move(s));
+}
+
+void scan_thermal_zones(ThermalRegistry& reg) {
+    DIR* dir = opendir("/sys/class/thermal");
+    if (!dir) return;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name = entry->d_name;
+        if (name.rfind("thermal_zone", 0) != 0) continue;
+        std::string base = "/sys/class/thermal/" + name + "/";
+        std::string type = trim(read_first_line(base + "type"));
+        if (type.empty()) continue;
+        std::string lower = to_lower(type);
+        bool cpuCandidate = !contains_any(lower, kCpuExclude) && contains_any(lower, kCpuInclude) &&
+                            lower.find("hw-trip") == std::string::npos;
+        add_sensor(reg, false, type, base + "temp", type, cpuCandidate);
+    }
+    closedir(dir);
+}
+
+void scan_hwmon(ThermalRegistry& reg) {
+    DIR* hdir = opendir("/sys/class/hwmon");
+    if (!hdir) return;
+    struct dirent* hentry;
+    while ((hentry = readdir(hdir)) != nullptr) {
+        std::string hname = hentry->d_name;
+        if (hname.rfind("hwmon", 0) != 0) continue;
+        std::string base = "/sys/class/hwmon/" + hname + "/";
+        std::string name = trim(read_first_line(base + "name"));
+        std::string nameLower = to_lower(name);
+        bool cpuCandidate = !contains_any(nameLower, kCpuExclude) && contains_any(nameLower, kCpuHwmonNames);
+
+        DIR* fdir = opendir(base.c_str());
+        if (!fdir) continue;
+        struct dirent* fentry;
+        while ((fentry = readdir(fdir)) != nullptr) {
+            std::string fname = fentry->d_name;
+            if (fname.rfind("temp", 0) != 0) continue;
+            if (fname.find("_input") == std::string::npos) continue;
+            std::string type = (name.empty() ? hname : name) + "/" + fname;
+            add_sensor(reg, true, type, base + fname, name, cpuCandidate);
+        }
+        closedir(fdir);
+    }
+    closedir(hdir);
+}
+
+void scan_cooling_devices(ThermalRegistry& reg) {
+    DIR* dir = opendir("/sys/class/thermal");
+    if (!dir) return;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name = entry->d_name;
+        if (name.rfind("cooling_device", 0) != 0) continue;
+        std::string base = "/sys/class/thermal/" + name + "/";
+        std::string type = trim(read_first_line(base + "type"));
+        if (type.empty()) continue;
+        int fd = open((base + "cur_state").c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) continue;
+        CoolingDevice dev;
+        dev.index = atoi(name.c_str() + strlen("cooling_device"));
+        dev.type = type;
+        dev.maxState = read_long_from_file(base + "max_state");
+        dev.fd = fd;
+        reg.coolingDevices.push_back(std::move(dev));
+    }
+    closedir(dir);
+}
+
+// Zones, cooling devices and hwmon chips come and go with drivers; their
+// uevents are the cue to rediscover early. Without the socket the slow
+// timer still applies.
+void open_uevent_socket_locked() {
+    g_uevent_opened = true;
+    int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+    if (fd < 0) {
+        LOGD("uevent socket unavailable (errno=%d), thermal rescans on timer only", errno);
+        return;
+    }
+    struct sockaddr_nl addr{};
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = 1;
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        LOGD("uevent bind failed (errno=%d), thermal rescans on timer only", errno);
+        close(fd);
+        return;
+    }
+    g_uevent_fd = fd;
+}
+
+bool drain_thermal_uevents_locked() {
+    if (g_uevent_fd < 0) return false;
+    bool relevant = false;
+    char buf[4096];
+    for (;;) {
+        ssize_t n = recv(g_uevent_fd, buf, sizeof(buf) - 1, MSG_DONTWAIT);
+        if (n < 0) {
+            // A full socket buffer dropped events we cannot inspect.
+            if (errno == ENOBUFS) relevant = true;
+            if (errno == EINTR || errno == ENOBUFS) continue;
+            break;
+        }
+        if (n == 0) break;
+        // Payload is NUL-separated KEY=VALUE pairs.
+        for (ssize_t i = 0; i < n; i += (ssize_t)strnlen(buf + i, (size_t)(n - i)) + 1) {
+            const char* kv = buf + i;
+            if (strncmp(kv, "SUBSYSTEM=thermal", 17) == 0 || strncmp(kv, "SUBSYSTEM=hwmon", 15) == 0) {
+                relevant = true;
+            }
+        }
+    }
+    return relevant;
+}
+
+} // namespace
+
+ThermalRegistry::~ThermalRegistry() {
+    for (const ThermalSensor& s : sensors) {
+        if (s.fd >= 0) close(s.fd);
+    }
+    for (const CoolingDevice& d : coolingDevices) {
+        if (d.fd >= 0) close(d.fd);
+    }
+}
+
+std::shared_ptr<const ThermalRegistry> thermal_registry() {
+    std::lock_guard<std::mutex> lock(g_thermal_mutex);
+    if (!g_uevent_opened) open_uevent_socket_locked();
+    long long now = now_ms();
+    bool changed = drain_thermal_uevents_locked();
+    if (g_thermal_registry && !changed && now < g_thermal_rescan_at_ms) return g_thermal_registry;
+
+    auto reg = std::make_shared<ThermalRegistry>();
+    reg->generation = ++g_thermal_generation;
+    scan_thermal_zones(*reg);
+    scan_hwmon(*reg);
+    scan_cooling_devices(*reg);
+    g_thermal_registry = reg;
+    g_thermal_rescan_at_ms = now + kThermalRescanMs;
+    return g_thermal_registry;
+}
+
+bool read_thermal_c(const ThermalSensor& sensor, double& celsius, long& rawOut) {
+    if (sensor.fd < 0) return false;
+    char buf[32];
+    ssize_t n = pread(sensor.fd, buf, sizeof(buf) - 1, 0);
+    if (n <= 0) return false;
+    std::string_view s(buf, (size_t)n);
+    long long raw = 0;
+    if (!parse_ll(s, raw)) return false;
+    double c = parse_temp_c((long)raw);
+    if (std::isnan(c)) return false;
+    rawOut = (long)raw;
+    celsius = c;
+    return true;
+}
+
+bool read_cooling_state(const CoolingDevice& device, long& state) {
+    if (device.fd < 0) return false;
+    char buf[32];
+    ssize_t n = pread(device.fd, buf, sizeof(buf) - 1, 0);
+    if (n <= 0) return false;
+    std::string_view s(buf, (size_t)n);
+    long long value = 0;
+    if (!parse_ll(s, value)) return false;
+    state = (long)value;
+    return true;
+}
+
+const char* thermal_class_name(ThermalClass cls) {
+    switch (cls) {
+        case kThermalCpu: return "cpu";
+        case kThermalApss: return "apss";
+        case kThermalSoc: return "soc";
+        case kThermalGpu: return "gpu";
+        case kThermalBattery: return "battery";
+        case kThermalSkin: return "skin";
+        default: return "other";
+    }
+}
+
+std::string get_thermal_table_json() {
+    std::shared_ptr<const ThermalRegistry> reg = thermal_registry();
+    std::stringstream ss;
+    ss << "{";
+    ss << "\"generation\":" << reg->generation << ",";
+    ss << "\"sensors\":[";
+    for (size_t i = 0; i < reg->sensors.size(); ++i) {
+        const ThermalSensor& s = reg->sensors[i];
+        double c = -1.0;
+        long raw = 0;
+        read_thermal_c(s, c, raw);
+        if (i > 0) ss << ",";
+        ss << "{\"type\":\"" << escape_json(s.type) << "\",";
+        ss << "\"source\":\"" << (s.hwmon ? "hwmon" : "thermal_zone") << "\",";
+        ss << "\"class\":\"" << thermal_class_name(s.cls) << "\",";
+        ss << "\"tempC\":" << c << ",";
+        ss << "\"raw\":" << raw << "}";
+    }
+    ss << "]";
+    ss << "}";
+    return ss.str();
+}
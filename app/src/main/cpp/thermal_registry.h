@@ -0,0 +1,69 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+enum ThermalClass {
+    kThermalCpu = 0,
+    kThermalApss,
+    kThermalSoc,
+    kThermalGpu,
+    kThermalBattery,
+    kThermalSkin,
+    kThermalOther
+};
+
+// One temperature input: a /sys/class/thermal zone or a hwmon temp*_input.
+struct ThermalSensor {
+    bool hwmon = false;
+    std::string type;        // zone type, or "<hwmon name>/<file>"
+    std::string typeLower;
+    std::string tempPath;
+    ThermalClass cls = kThermalOther;
+    // Whether get_cpu_temp_c may pick it: zones that pass the CPU keyword
+    // filter, hwmon chips whose name looks like a CPU/SoC sensor.
+    bool cpuCandidate = false;
+    int fd = -1;
+};
+
+// A /sys/class/thermal/cooling_device*. max_state is fixed per device.
+struct CoolingDevice {
+    int index = -1;  // N of cooling_deviceN; types repeat, indices do not
+    std::string type;
+    long maxState = 0;
+    int fd = -1;  // cur_state
+};
+
+// Every sensor and cooling device found by one discovery pass, with the
+// files polled per tick held open. Descriptors close when the last holder
+// of a superseded registry lets go.
+struct ThermalRegistry {
+    unsigned long long generation = 0;
+    std::vector<ThermalSensor> sensors;
+    std::vector<CoolingDevice> coolingDevices;
+
+    ThermalRegistry() = default;
+    ThermalRegistry(const ThermalRegistry&) = delete;
+    ThermalRegistry& operator=(const ThermalRegistry&) = delete;
+    ~ThermalRegistry();
+};
+
+// Rediscovery happens at most this often, or sooner when a thermal/hwmon
+// uevent arrives.
+constexpr long long kThermalRescanMs = 60000;
+
+// Current registry, rescanning first when it is stale. Never null.
+std::shared_ptr<const ThermalRegistry> thermal_registry();
+
+// One pread of the sensor's temp file. Returns false when it cannot be read
+// or the value is out of range; rawOut is the unscaled value.
+bool read_thermal_c(const ThermalSensor& sensor, double& celsius, long& rawOut);
+
+// One pread of the device's cur_state.
+bool read_cooling_state(const CoolingDevice& device, long& state);
+
+const char* thermal_class_name(ThermalClass cls);
+
+// Every sensor with its class and current reading.
+std::string get_thermal_table_json();
@@ -0,0 +1,107 @@
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+constexpr unsigned kMaxWorkers = 8;
+
+struct Job {
+    const ChunkFn* fn = nullptr;
+    size_t count = 0;
+    size_t chunkSize = 1;
+    std::atomic<size_t> next{0};
+    unsigned active = 0;
+};
+
+struct PoolState {
+    std::mutex submitMutex;
+    std::mutex mutex;
+    std::condition_variable workCv;
+    std::condition_variable doneCv;
+    Job* job = nullptr;
+    unsigned long long jobSeq = 0;
+    unsigned size = 1;
+};
+
+// Never destroyed: the detached workers block on these condition variables
+// for the life of the process, and tearing them down in static destructors
+// would hang process exit.
+PoolState* g_pool = nullptr;
+std::once_flag g_pool_once;
+
+void drain(Job& job, unsigned worker) {
+    while (true) {
+        size_t begin = job.next.fetch_add(job.chunkSize);
+        if (begin >= job.count) break;
+        size_t end = std::min(begin + job.chunkSize, job.count);
+        (*job.fn)(begin, end, worker);
+    }
+}
+
+void worker_main(unsigned worker) {
+    PoolState& pool = *g_pool;
+    unsigned long long seen = 0;
+    std::unique_lock<std::mutex> lock(pool.mutex);
+    while (true) {
+        pool.workCv.wait(lock, [&] { return pool.job != nullptr && pool.jobSeq != seen; });
+        seen = pool.jobSeq;
+        Job* job = pool.job;
+        job->active++;
+        lock.unlock();
+        drain(*job, worker);
+        lock.lock();
+        if (--job->active == 0) pool.doneCv.notify_all();
+    }
+}
+
+void init_pool() {
+    g_pool = new PoolState();
+    unsigned hw = std::thread::hardware_concurrency();
+    g_pool->size = std::clamp(hw, 1u, kMaxWorkers);
+    // Worker 0 is always the submitting thread.
+    for (unsigned i = 1; i < g_pool->size; ++i) {
+        std::thread(worker_main, i).detach();
+    }
+}
+
+} // namespace
+
+unsigned worker_pool_size() {
+    std::call_once(g_pool_once, init_pool);
+    return g_pool->size;
+}
+
+void parallel_for(size_t count, size_t chunkSize, const ChunkFn& fn) {
+    if (count == 0) return;
+    if (chunkSize == 0) chunkSize = 1;
+    if (worker_pool_size() == 1 || count <= chunkSize) {
+        fn(0, count, 0);
+        return;
+    }
+
+    PoolState& pool = *g_pool;
+    std::lock_guard<std::mutex> submit(pool.submitMutex);
+    Job job;
+    job.fn = &fn;
+    job.count = count;
+    job.chunkSize = chunkSize;
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        pool.job = &job;
+        pool.jobSeq++;
+    }
+    pool.workCv.notify_all();
+
+    drain(job, 0);
+
+    // Unpublish first so a worker that wakes late cannot pick up a job whose
+    // storage is about to go out of scope, then wait for stragglers.
+    std::unique_lock<std::mutex> lock(pool.mutex);
+    pool.job = nullptr;
+    pool.doneCv.wait(lock, [&] { return job.active == 0; });
+}
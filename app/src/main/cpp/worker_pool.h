@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+// Callback for one chunk [begin, end) of a parallel job. worker is a stable
+// index in [0, worker_pool_size()) so callers can keep per-worker buffers
+// without locking.
+using ChunkFn = std::function<void(size_t begin, size_t end, unsigned worker)>;
+
+// Number of threads that take part in a job, including the calling thread.
+unsigned worker_pool_size();
+
+// Splits [0, count) into chunks of chunkSize and runs them on the shared
+// bounded pool. Idle workers claim the next unprocessed chunk, so uneven
+// chunks balance out. Blocks until every chunk has finished. Jobs from
+// different callers are serialized.
+void parallel_for(size_t count, size_t chunkSize, const ChunkFn& fn);
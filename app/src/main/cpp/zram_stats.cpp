@@ -0,0 +1,175 @@
+#include "zram_stats.h"
+#include "native_utils.h"
+#include "proc_reader.h"
+
+#include <ctime>
+#include <dirent.h>
+#include <mutex>
+#include <sstream>
+#include <unistd.h>
+
+namespace {
+
+struct ZramEntry {
+    std::string name;
+    std::string algorithm;
+    std::string mmStatPath;
+    std::string ioStatPath;
+    std::string disksizePath;
+};
+
+std::mutex g_zram_mutex;
+std::vector<ZramEntry> g_zram_devices;
+long long g_zram_rescan_at_ms = 0;
+
+long long now_ms() {
+    struct timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000LL;
+}
+
+// "lzo lzo-rle [lz4] zstd" -> "lz4"
+std::string selected_algorithm(const std::string& line) {
+    size_t open = line.find('[');
+    size_t close = line.find(']', open);
+    if (open == std::string::npos || close == std::string::npos) return trim(line);
+    return line.substr(open + 1, close - open - 1);
+}
+
+std::vector<ZramEntry> zram_devices() {
+    std::lock_guard<std::mutex> lock(g_zram_mutex);
+    long long now = now_ms();
+    if (now < g_zram_rescan_at_ms) return g_zram_devices;
+
+    std::vector<ZramEntry> found;
+    DIR* dir = opendir("/sys/block");
+    if (dir) {
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != nullptr) {
+            std::string name = entry->d_name;
+            if (name.rfind("zram", 0) != 0) continue;
+            std::string base = "/sys/block/" + name + "/";
+            ZramEntry z;
+            z.name = name;
+            z.algorithm = selected_algorithm(read_first_line(base + "comp_algorithm"));
+            z.mmStatPath = base + "mm_stat";
+            z.ioStatPath = base + "io_stat";
+            z.disksizePath = base + "disksize";
+            found.push_back(std::move(z));
+        }
+        closedir(dir);
+    }
+    g_zram_devices = found;
+    g_zram_rescan_at_ms = now + kZramRescanMs;
+    return found;
+}
+
+void parse_fields(std::string_view line, long long* const* fields, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (!parse_ll(line, *fields[i])) break;
+    }
+}
+
+// Filename  Type  Size  Used  Priority, sizes in kB.
+std::vector<SwapArea> read_swaps() {
+    std::vector<SwapArea> out;
+    std::string_view content = cached_read_view("/proc/swaps");
+    next_line(content);  // header
+    while (!content.empty()) {
+        std::string_view line = next_line(content);
+        SwapArea area;
+        area.path = std::string(next_token(line));
+        area.type = std::string(next_token(line));
+        if (area.path.empty()) continue;
+        long long sizeKb = 0;
+        long long usedKb = 0;
+        long long priority = 0;
+        parse_ll(line, sizeKb);
+        parse_ll(line, usedKb);
+        parse_ll(line, priority);
+        area.sizeBytes = sizeKb * 1024LL;
+        area.usedBytes = usedKb * 1024LL;
+        area.priority = (int)priority;
+        out.push_back(std::move(area));
+    }
+    return out;
+}
+
+} // namespace
+
+ZramSwapSnapshot read_zram_swap() {
+    ZramSwapSnapshot snap;
+    for (const ZramEntry& e : zram_devices()) {
+        ZramDevice d;
+        d.name = e.name;
+        d.algorithm = e.algorithm;
+        cached_read_ll(e.disksizePath, d.disksizeBytes);
+        // An unconfigured device has disksize 0 and nothing worth reading.
+        if (d.disksizeBytes <= 0) continue;
+
+        // orig_data_size compr_data_size mem_used_total mem_limit
+        // mem_used_max same_pages pages_compacted huge_pages
+        long long* mm[] = {&d.origDataBytes, &d.comprDataBytes, &d.memUsedTotalBytes, &d.memLimitBytes,
+                           &d.memUsedMaxBytes, &d.samePages, &d.pagesCompacted, &d.hugePages};
+        parse_fields(cached_read_view(e.mmStatPath), mm, sizeof(mm) / sizeof(mm[0]));
+        // failed_reads failed_writes invalid_io notify_free
+        long long* io[] = {&d.failedReads, &d.failedWrites};
+        parse_fields(cached_read_view(e.ioStatPath), io, sizeof(io) / sizeof(io[0]));
+
+        snap.origDataBytes += d.origDataBytes;
+        snap.comprDataBytes += d.comprDataBytes;
+        snap.memUsedTotalBytes += d.memUsedTotalBytes;
+        snap.samePages += d.samePages;
+        snap.zram.push_back(std::move(d));
+    }
+    snap.swaps = read_swaps();
+    return snap;
+}
+
+std::string zram_swap_json(const ZramSwapSnapshot& snap, double swapInPagesPerSec, double swapOutPagesPerSec) {
+    static const long pageSize = sysconf(_SC_PAGESIZE) > 0 ? sysconf(_SC_PAGESIZE) : 4096;
+    // RAM actually spent per byte stored; same-filled pages cost nothing.
+    double ratio = snap.memUsedTotalBytes > 0 ? (double)snap.origDataBytes / (double)snap.memUsedTotalBytes : 0.0;
+
+    std::stringstream ss;
+    ss << "{";
+    ss << "\"origDataBytes\":" << snap.origDataBytes << ",";
+    ss << "\"comprDataBytes\":" << snap.comprDataBytes << ",";
+    ss << "\"memUsedTotalBytes\":" << snap.memUsedTotalBytes << ",";
+    ss << "\"samePages\":" << snap.samePages << ",";
+    ss << "\"compressionRatio\":" << ratio << ",";
+    ss << "\"swapInBytesPerSec\":" << (long long)(swapInPagesPerSec * pageSize) << ",";
+    ss << "\"swapOutBytesPerSec\":" << (long long)(swapOutPagesPerSec * pageSize) << ",";
+    ss << "\"devices\":[";
+    for (size_t i = 0; i < snap.zram.size(); ++i) {
+        const ZramDevice& d = snap.zram[i];
+        if (i > 0) ss << ",";
+        ss << "{\"name\":\"" << escape_json(d.name) << "\",";
+        ss << "\"algorithm\":\"" << escape_json(d.algorithm) << "\",";
+        ss << "\"disksizeBytes\":" << d.disksizeBytes << ",";
+        ss << "\"origDataBytes\":" << d.origDataBytes << ",";
+        ss << "\"comprDataBytes\":" << d.comprDataBytes << ",";
+        ss << "\"memUsedTotalBytes\":" << d.memUsedTotalBytes << ",";
+        ss << "\"memLimitBytes\":" << d.memLimitBytes << ",";
+        ss << "\"memUsedMaxBytes\":" << d.memUsedMaxBytes << ",";
+        ss << "\"samePages\":" << d.samePages << ",";
+        ss << "\"pagesCompacted\":" << d.pagesCompacted << ",";
+        ss << "\"hugePages\":" << d.hugePages << ",";
+        ss << "\"failedReads\":" << d.failedReads << ",";
+        ss << "\"failedWrites\":" << d.failedWrites << "}";
+    }
+    ss << "],";
+    ss << "\"swaps\":[";
+    for (size_t i = 0; i < snap.swaps.size(); ++i) {
+        const SwapArea& s = snap.swaps[i];
+        if (i > 0) ss << ",";
+        ss << "{\"path\":\"" << escape_json(s.path) << "\",";
+        ss << "\"type\":\"" << escape_json(s.type) << "\",";
+        ss << "\"sizeBytes\":" << s.sizeBytes << ",";
+        ss << "\"usedBytes\":" << s.usedBytes << ",";
+        ss << "\"priority\":" << s.priority << "}";
+    }
+    ss << "]";
+    ss << "}";
+    return ss.str();
+}
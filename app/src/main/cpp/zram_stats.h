@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// One /sys/block/zramN. Sizes are bytes from mm_stat; counters from io_stat.
+struct ZramDevice {
+    std::string name;
+    std::string algorithm;  // the bracketed entry of comp_algorithm
+    long long disksizeBytes = 0;
+    long long origDataBytes = 0;
+    long long comprDataBytes = 0;
+    long long memUsedTotalBytes = 0;
+    long long memLimitBytes = 0;
+    long long memUsedMaxBytes = 0;
+    long long samePages = 0;
+    long long pagesCompacted = 0;
+    long long hugePages = 0;
+    long long failedReads = 0;
+    long long failedWrites = 0;
+};
+
+// One /proc/swaps row; sizes in bytes.
+struct SwapArea {
+    std::string path;
+    std::string type;
+    long long sizeBytes = 0;
+    long long usedBytes = 0;
+    int priority = 0;
+};
+
+struct ZramSwapSnapshot {
+    std::vector<ZramDevice> zram;
+    std::vector<SwapArea> swaps;
+    long long origDataBytes = 0;
+    long long comprDataBytes = 0;
+    long long memUsedTotalBytes = 0;
+    long long samePages = 0;
+};
+
+// The zram device list and algorithms only change on reconfiguration, so
+// /sys/block is rescanned at most this often.
+constexpr long long kZramRescanMs = 10000;
+
+ZramSwapSnapshot read_zram_swap();
+
+// {"devices":[...],"swaps":[...],"origDataBytes",...,"compressionRatio",
+//  "swapInBytesPerSec","swapOutBytesPerSec"} for the memory snapshot. The
+// rates are vmstat pswpin/pswpout pages per second.
+std::string zram_swap_json(const ZramSwapSnapshot& snap, double swapInPagesPerSec, double swapOutPagesPerSec);
@@ -47,6 +47,7 @@ private fun PerformanceRoot(onBack: () -> Unit) {
     val gpuSeries by viewModel.gpuSeries.collectAsState()
     val memorySnapshot by viewModel.memorySnapshot.collectAsState()
     val memorySeries by viewModel.memorySeries.collectAsState()
+    val pageCacheFiles by viewModel.pageCacheFiles.collectAsState()
     val diskSnapshot by viewModel.diskSnapshot.collectAsState()
     val diskSeries by viewModel.diskSeries.collectAsState()
     val netSnapshot by viewModel.netSnapshot.collectAsState()
@@ -82,6 +83,7 @@ private fun PerformanceRoot(onBack: () -> Unit) {
             gpuSeries = gpuSeries,
             memorySnapshot = memorySnapshot,
             memorySeries = memorySeries,
+            pageCacheFiles = pageCacheFiles,
             diskSnapshot = diskSnapshot,
             diskSeries = diskSeries,
             netSnapshot = netSnapshot,
@@ -92,6 +94,7 @@ private fun PerformanceRoot(onBack: () -> Unit) {
             onCpuPoll = { viewModel.refreshCpuSnapshot() },
             onGpuPoll = { viewModel.refreshGpuSnapshot() },
             onMemoryPoll = { viewModel.refreshMemorySnapshot() },
+            onPageCachePoll = { viewModel.refreshPageCacheFiles() },
             onDiskPoll = { viewModel.refreshDiskSnapshot() },
             onNetPoll = { viewModel.refreshNetSnapshot() },
             onBatteryPoll = { viewModel.refreshBatterySnapshot() },
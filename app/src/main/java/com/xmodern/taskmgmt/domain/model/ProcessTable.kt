@@ -0,0 +1,114 @@
+package com.xmodern.taskmgmt.domain.model
+
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+data class ProcessTableRow(
+    val pid: Int,
+    val name: String,
+    val ramBytes: Long,
+    val cpuUsage: Double,
+    val nice: Int,
+    // From smaps_rollup when PSS collection is on; -1 until read.
+    val pssBytes: Long = -1L,
+    val ussBytes: Long = -1L,
+    val swapPssBytes: Long = -1L
+)
+
+// Decoded form of the binary process table built by process_table.cpp.
+// See process_table.h for the byte layout.
+data class ProcessTable(
+    val generation: Long,
+    val isDelta: Boolean,
+    val globalCpu: Double,
+    val ramUsed: Long,
+    val ramTotal: Long,
+    val rows: List<ProcessTableRow>,
+    val removedPids: IntArray,
+    // Rows matching a windowed query before offset/limit; 0 for delta tables.
+    val totalRows: Int = 0
+) {
+    companion object {
+        private const val MAGIC = 0x42415450
+        private const val MIN_VERSION = 1
+        private const val MAX_VERSION = 3
+        private const val FLAG_DELTA = 1
+        private const val HEADER_SIZE = 56
+
+        // Sort keys understood by queryProcessTable (ProcessSortKey in process_scan.h).
+        const val SORT_CPU = 0
+        const val SORT_RAM = 1
+        const val SORT_NAME = 2
+        const val SORT_PID = 3
+        const val SORT_NICE = 4
+        const val SORT_PSS = 5
+
+        // Returns null for a table that is truncated or from an unknown schema version.
+        fun decode(bytes: ByteArray): ProcessTable? {
+            if (bytes.size < HEADER_SIZE) return null
+            val buf = ByteBuffer.wrap(bytes).order(ByteOrder.LITTLE_ENDIAN)
+            if (buf.getInt(0) != MAGIC) return null
+            val version = buf.getShort(4).toInt()
+            if (version < MIN_VERSION || version > MAX_VERSION) return null
+            val flags = buf.getShort(6).toInt()
+            val generation = buf.getLong(8)
+            val globalCpu = buf.getDouble(16)
+            val ramUsed = buf.getLong(24)
+            val ramTotal = buf.getLong(32)
+            val n = buf.getInt(40)
+            val m = buf.getInt(44)
+            val blobSize = buf.getInt(48)
+            val totalRows = if (version >= 2) buf.getInt(52) else 0
+            if (n < 0 || m < 0 || blobSize < 0) return null
+
+            // Size the table in Long first: a corrupt count must not overflow
+            // the Int offsets below into something that passes the check.
+            val hasPss = version >= 3
+            val rowBytes = (if (hasPss) 5L else 2L) * 8 + 3L * 4  // i64 columns, pid, nice, name offset
+            val needed = HEADER_SIZE + n.toLong() * rowBytes + 4L + m.toLong() * 4 + blobSize
+            if (needed > bytes.size) return null
+
+            val ramOff = HEADER_SIZE
+            val cpuOff = ramOff + n * 8
+            val pssOff = cpuOff + n * 8
+            val ussOff = pssOff + n * 8
+            val swapPssOff = ussOff + n * 8
+            val pidOff = if (hasPss) swapPssOff + n * 8 else pssOff
+            val niceOff = pidOff + n * 4
+            val nameOff = niceOff + n * 4
+            val removedOff = nameOff + (n + 1) * 4
+            val blobOff = removedOff + m * 4
+
+            val rows = ArrayList<ProcessTableRow>(n)
+            for (i in 0 until n) {
+                val start = buf.getInt(nameOff + i * 4)
+                val end = buf.getInt(nameOff + (i + 1) * 4)
+                if (start < 0 || end < start || end > blobSize) return null
+                rows.add(
+                    ProcessTableRow(
+                        pid = buf.getInt(pidOff + i * 4),
+                        name = String(bytes, blobOff + start, end - start, Charsets.UTF_8),
+                        ramBytes = buf.getLong(ramOff + i * 8),
+                        cpuUsage = buf.getDouble(cpuOff + i * 8),
+                        nice = buf.getInt(niceOff + i * 4),
+                        pssBytes = if (hasPss) buf.getLong(pssOff + i * 8) else -1L,
+                        ussBytes = if (hasPss) buf.getLong(ussOff + i * 8) else -1L,
+                        swapPssBytes = if (hasPss) buf.getLong(swapPssOff + i * 8) else -1L
+                    )
+                )
+            }
+            val removed = IntArray(m) { buf.getInt(removedOff + it * 4) }
+
+            return ProcessTable(
+                generation = generation,
+                isDelta = (flags and FLAG_DELTA) != 0,
+                globalCpu = globalCpu,
+                ramUsed = ramUsed,
+                ramTotal = ramTotal,
+                rows = rows,
+                removedPids = removed,
+                totalRows = totalRows
+            )
+        }
+    }
+}
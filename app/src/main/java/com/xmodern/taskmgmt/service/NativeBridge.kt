@@ -18,9 +18,25 @@ object NativeBridge {
 
     external fun getProcessList(): String
 
+    external fun getProcessListDelta(sinceGeneration: Long): String
+
+    external fun getProcessTable(sinceGeneration: Long): ByteArray
+
+    external fun queryProcessTable(
+        sortKey: Int,
+        descending: Boolean,
+        filter: String,
+        offset: Int,
+        limit: Int
+    ): ByteArray
+
+    external fun setProcessDeltaThresholds(cpuPercent: Double, ramBytes: Long)
+
+    external fun setPssCollection(enabled: Boolean, budgetUs: Long)
+
     external fun getProcessExtendedInfo(pid: Int): String
 
-    external fun getProcessDeepSnapshot(pid: Int): String
+    external fun getProcessDeepSnapshot(pid: Int, pageCache: Boolean): String
 
     external fun sendSignal(pid: Int, signal: Int): Boolean
 
@@ -32,12 +48,30 @@ object NativeBridge {
 
     external fun getCpuSnapshotJson(): String
 
+    external fun getCpuResidencyJson(consumer: Long): String
+
+    external fun getThermalTableJson(): String
+
+    external fun getThermalThrottleJson(sinceSeq: Long): String
+
     external fun getVulkanInfoJson(): String
 
     external fun getGpuSnapshotJson(): String
 
     external fun getMemorySnapshotJson(): String
 
+    external fun getPageCacheTopJson(limit: Int): String
+
+    external fun getPsiSnapshotJson(): String
+
+    external fun addPsiTrigger(resource: Int, full: Boolean, stallUs: Long, windowUs: Long): Int
+
+    external fun removePsiTrigger(triggerId: Int)
+
+    external fun waitPsiEvents(sinceSeq: Long, timeoutMs: Long): String
+
+    external fun armKillPressureTrigger(): Int
+
     external fun getDiskSnapshotJson(): String
 
     external fun getNetSnapshotJson(): String
@@ -45,6 +79,10 @@ object NativeBridge {
     external fun getPerformanceMiniSnapshotJson(): String
 
     external fun getBatterySnapshotJson(): String
+
+    external fun startSampler(intervalMs: Long, collectors: Int): Int
+
+    external fun stopSampler(consumerId: Int)
 }
 
                 
@@ -8,11 +8,40 @@ import com.topjohnwu.superuser.ipc.RootService
 
 class RootBackendService : RootService() {
 
+    // PSI triggers added by clients. The kernel keeps a trigger for as long as
+    // its fd is open, so these are released when the clients go away.
+    private val clientTriggers = mutableSetOf<Int>()
+
+    // Sampler consumers registered by clients, dropped the same way.
+    private val clientSamplers = mutableSetOf<Int>()
+
     override fun onCreate() {
         super.onCreate()
         Log.d("TaskManager", "RootBackendService Created (PID: ${android.os.Process.myPid()})")
     }
 
+    // libsu calls this when the last client unbinds or its process dies.
+    override fun onUnbind(intent: Intent): Boolean {
+        releaseClientResources()
+        return super.onUnbind(intent)
+    }
+
+    override fun onDestroy() {
+        releaseClientResources()
+        super.onDestroy()
+    }
+
+    private fun releaseClientResources() {
+        val triggers = synchronized(clientTriggers) {
+            clientTriggers.toList().also { clientTriggers.clear() }
+        }
+        triggers.forEach { NativeBridge.removePsiTrigger(it) }
+        val samplers = synchronized(clientSamplers) {
+            clientSamplers.toList().also { clientSamplers.clear() }
+        }
+        samplers.forEach { NativeBridge.stopSampler(it) }
+    }
+
     override fun onBind(intent: Intent): IBinder {
         Log.d("TaskManager", "RootBackendService Bound")
         return object : IRootService.Stub() {
@@ -23,11 +52,31 @@ class RootBackendService : RootService() {
                 return NativeBridge.getProcessList()
             }
 
+            override fun getProcessListDelta(sinceGeneration: Long): String =
+                NativeBridge.getProcessListDelta(sinceGeneration)
+
+            override fun getProcessTable(sinceGeneration: Long): ByteArray =
+                NativeBridge.getProcessTable(sinceGeneration)
+
+            override fun queryProcessTable(
+                sortKey: Int,
+                descending: Boolean,
+                filter: String,
+                offset: Int,
+                limit: Int
+            ): ByteArray = NativeBridge.queryProcessTable(sortKey, descending, filter, offset, limit)
+
+            override fun setProcessDeltaThresholds(cpuPercent: Double, ramBytes: Long) =
+                NativeBridge.setProcessDeltaThresholds(cpuPercent, ramBytes)
+
+            override fun setPssCollection(enabled: Boolean, budgetUs: Long) =
+                NativeBridge.setPssCollection(enabled, budgetUs)
+
             override fun getProcessExtendedInfo(pid: Int): String =
                 NativeBridge.getProcessExtendedInfo(pid)
 
-            override fun getProcessDeepSnapshot(pid: Int): String =
-                NativeBridge.getProcessDeepSnapshot(pid)
+            override fun getProcessDeepSnapshot(pid: Int, pageCache: Boolean): String =
+                NativeBridge.getProcessDeepSnapshot(pid, pageCache)
 
             override fun sendSignal(pid: Int, signal: Int): Boolean =
                 NativeBridge.sendSignal(pid, signal)
@@ -41,12 +90,43 @@ class RootBackendService : RootService() {
 
             override fun getCpuSnapshotJson(): String = NativeBridge.getCpuSnapshotJson()
 
+            override fun getCpuResidencyJson(consumer: Long): String = NativeBridge.getCpuResidencyJson(consumer)
+
+            override fun getThermalTableJson(): String = NativeBridge.getThermalTableJson()
+
+            override fun getThermalThrottleJson(sinceSeq: Long): String =
+                NativeBridge.getThermalThrottleJson(sinceSeq)
+
             override fun getVulkanInfoJson(): String = NativeBridge.getVulkanInfoJson()
 
             override fun getGpuSnapshotJson(): String = NativeBridge.getGpuSnapshotJson()
 
             override fun getMemorySnapshotJson(): String = NativeBridge.getMemorySnapshotJson()
 
+            override fun getPageCacheTopJson(limit: Int): String = NativeBridge.getPageCacheTopJson(limit)
+
+            override fun getPsiSnapshotJson(): String = NativeBridge.getPsiSnapshotJson()
+
+            override fun addPsiTrigger(resource: Int, full: Boolean, stallUs: Long, windowUs: Long): Int {
+                val id = NativeBridge.addPsiTrigger(resource, full, stallUs, windowUs)
+                if (id >= 0) synchronized(clientTriggers) { clientTriggers.add(id) }
+                return id
+            }
+
+            override fun removePsiTrigger(triggerId: Int) {
+                synchronized(clientTriggers) { clientTriggers.remove(triggerId) }
+                NativeBridge.removePsiTrigger(triggerId)
+            }
+
+            override fun waitPsiEvents(sinceSeq: Long, timeoutMs: Long): String =
+                NativeBridge.waitPsiEvents(sinceSeq, timeoutMs)
+
+            override fun armKillPressureTrigger(): Int {
+                val id = NativeBridge.armKillPressureTrigger()
+                if (id >= 0) synchronized(clientTriggers) { clientTriggers.add(id) }
+                return id
+            }
+
             override fun getDiskSnapshotJson(): String = NativeBridge.getDiskSnapshotJson()
 
             override fun getNetSnapshotJson(): String = NativeBridge.getNetSnapshotJson()
@@ -55,6 +135,17 @@ class RootBackendService : RootService() {
                 NativeBridge.getPerformanceMiniSnapshotJson()
 
             override fun getBatterySnapshotJson(): String = NativeBridge.getBatterySnapshotJson()
+
+            override fun startSampler(intervalMs: Long, collectors: Int): Int {
+                val id = NativeBridge.startSampler(intervalMs, collectors)
+                if (id >= 0) synchronized(clientSamplers) { clientSamplers.add(id) }
+                return id
+            }
+
+            override fun stopSampler(consumerId: Int) {
+                synchronized(clientSamplers) { clientSamplers.remove(consumerId) }
+                NativeBridge.stopSampler(consumerId)
+            }
         }
     }
 }
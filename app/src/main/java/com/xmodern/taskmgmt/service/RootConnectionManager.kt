@@ -7,7 +7,9 @@ import android.content.ServiceConnection
 import android.os.IBinder
 import android.util.Log
 import com.xmodern.taskmgmt.IRootService
+import com.xmodern.taskmgmt.domain.model.ProcessTable
 import com.topjohnwu.superuser.ipc.RootService
+import java.util.concurrent.atomic.AtomicLong
 
 class RootConnectionManager private constructor(private val context: Context) {
 
@@ -15,6 +17,16 @@ class RootConnectionManager private constructor(private val context: Context) {
     private var isBound = false
 
     companion object {
+        // Sampler collectors; mirror SamplerCollector in sampler.h.
+        const val SAMPLE_PROCESSES = 1 shl 0
+        const val SAMPLE_CPU = 1 shl 1
+        const val SAMPLE_GPU = 1 shl 2
+        const val SAMPLE_MEMORY = 1 shl 3
+        const val SAMPLE_DISK = 1 shl 4
+        const val SAMPLE_NET = 1 shl 5
+        const val SAMPLE_PERFORMANCE_MINI = 1 shl 6
+        const val SAMPLE_BATTERY = 1 shl 7
+
         @Volatile
         private var instance: RootConnectionManager? = null
 
@@ -69,6 +81,57 @@ class RootConnectionManager private constructor(private val context: Context) {
         }
     }
 
+    fun getProcessListDelta(sinceGeneration: Long): String? {
+        return try {
+            rootService?.getProcessListDelta(sinceGeneration)
+        } catch (e: Exception) {
+            Log.e("TaskManager", "Error fetching process list delta", e)
+            null
+        }
+    }
+
+    fun getProcessTable(sinceGeneration: Long): ProcessTable? {
+        return try {
+            rootService?.getProcessTable(sinceGeneration)?.let { ProcessTable.decode(it) }
+        } catch (e: Exception) {
+            Log.e("TaskManager", "Error fetching process table", e)
+            null
+        }
+    }
+
+    fun queryProcessTable(
+        sortKey: Int,
+        descending: Boolean,
+        filter: String,
+        offset: Int,
+        limit: Int
+    ): ProcessTable? {
+        return try {
+            rootService?.queryProcessTable(sortKey, descending, filter, offset, limit)
+                ?.let { ProcessTable.decode(it) }
+        } catch (e: Exception) {
+            Log.e("TaskManager", "Error querying process table", e)
+            null
+        }
+    }
+
+    fun setProcessDeltaThresholds(cpuPercent: Double, ramBytes: Long) {
+        try {
+            rootService?.setProcessDeltaThresholds(cpuPercent, ramBytes)
+        } catch (e: Exception) {
+            Log.e("TaskManager", "Error setting delta thresholds", e)
+        }
+    }
+
+    fun setPssCollection(enabled: Boolean, budgetUs: Long): Boolean {
+        return try {
+            rootService?.setPssCollection(enabled, budgetUs) != null
+        } catch (e: Exception) {
+            Log.e("TaskManager", "Error setting PSS collection", e)
+            false
+        }
+    }
+
     fun getProcessExtendedInfo(pid: Int): String? {
         return try {
             rootService?.getProcessExtendedInfo(pid)
@@ -78,9 +141,9 @@ class RootConnectionManager private constructor(private val context: Context) {
         }
     }
 
-    fun getProcessDeepSnapshot(pid: Int): String? {
+    fun getProcessDeepSnapshot(pid: Int, pageCache: Boolean = false): String? {
         return try {
-            rootService?.getProcessDeepSnapshot(pid)
+            rootService?.getProcessDeepSnapshot(pid, pageCache)
         } catch (e: Exception) {
             Log.e("TaskManager", "Error fetching deep snapshot", e)
             null
@@ -133,6 +196,39 @@ class RootConnectionManager private constructor(private val context: Context) {
         }
     }
 
+    // Keys for getCpuResidencyJson. Each caller takes its own, so callers
+    // polling at different rates never shorten each other's window.
+    private val residencyConsumers = AtomicLong()
+
+    fun newResidencyConsumer(): Long = residencyConsumers.incrementAndGet()
+
+    fun getCpuResidencyJson(consumer: Long): String? {
+        return try {
+            rootService?.getCpuResidencyJson(consumer)
+        } catch (e: Exception) {
+            Log.e("TaskManager", "Error getting CPU residency", e)
+            null
+        }
+    }
+
+    fun getThermalTableJson(): String? {
+        return try {
+            rootService?.thermalTableJson
+        } catch (e: Exception) {
+            Log.e("TaskManager", "Error getting thermal table", e)
+            null
+        }
+    }
+
+    fun getThermalThrottleJson(sinceSeq: Long): String? {
+        return try {
+            rootService?.getThermalThrottleJson(sinceSeq)
+        } catch (e: Exception) {
+            Log.e("TaskManager", "Error getting thermal throttle state", e)
+            null
+        }
+    }
+
     fun getVulkanInfoJson(): String? {
         return try {
             rootService?.vulkanInfoJson
@@ -160,6 +256,59 @@ class RootConnectionManager private constructor(private val context: Context) {
         }
     }
 
+    fun getPageCacheTopJson(limit: Int): String? {
+        return try {
+            rootService?.getPageCacheTopJson(limit)
+        } catch (e: Exception) {
+            Log.e("TaskManager", "Error getting page cache residency", e)
+            null
+        }
+    }
+
+    fun getPsiSnapshotJson(): String? {
+        return try {
+            rootService?.psiSnapshotJson
+        } catch (e: Exception) {
+            Log.e("TaskManager", "Error getting pressure snapshot", e)
+            null
+        }
+    }
+
+    fun addPsiTrigger(resource: Int, full: Boolean, stallUs: Long, windowUs: Long): Int {
+        return try {
+            rootService?.addPsiTrigger(resource, full, stallUs, windowUs) ?: -1
+        } catch (e: Exception) {
+            Log.e("TaskManager", "Error adding pressure trigger", e)
+            -1
+        }
+    }
+
+    fun removePsiTrigger(triggerId: Int) {
+        try {
+            rootService?.removePsiTrigger(triggerId)
+        } catch (e: Exception) {
+            Log.e("TaskManager", "Error removing pressure trigger", e)
+        }
+    }
+
+    fun waitPsiEvents(sinceSeq: Long, timeoutMs: Long): String? {
+        return try {
+            rootService?.waitPsiEvents(sinceSeq, timeoutMs)
+        } catch (e: Exception) {
+            Log.e("TaskManager", "Error waiting for pressure events", e)
+            null
+        }
+    }
+
+    fun armKillPressureTrigger(): Int {
+        return try {
+            rootService?.armKillPressureTrigger() ?: -1
+        } catch (e: Exception) {
+            Log.e("TaskManager", "Error arming kill pressure trigger", e)
+            -1
+        }
+    }
+
     fun getDiskSnapshotJson(): String? {
         return try {
             rootService?.diskSnapshotJson
@@ -195,4 +344,22 @@ class RootConnectionManager private constructor(private val context: Context) {
             null
         }
     }
+
+    // Returns a consumer id for stopSampler, or -1.
+    fun startSampler(intervalMs: Long, collectors: Int): Int {
+        return try {
+            rootService?.startSampler(intervalMs, collectors) ?: -1
+        } catch (e: Exception) {
+            Log.e("TaskManager", "Error starting sampler", e)
+            -1
+        }
+    }
+
+    fun stopSampler(consumerId: Int) {
+        try {
+            rootService?.stopSampler(consumerId)
+        } catch (e: Exception) {
+            Log.e("TaskManager", "Error stopping sampler", e)
+        }
+    }
 }
@@ -72,6 +72,7 @@ fun PerformanceScreen(
     gpuSeries: List<Float>,
     memorySnapshot: MemorySnapshot?,
     memorySeries: List<Float>,
+    pageCacheFiles: List<PageCacheFile>,
     diskSnapshot: DiskSnapshot?,
     diskSeries: List<Float>,
     netSnapshot: NetSnapshot?,
@@ -82,6 +83,7 @@ fun PerformanceScreen(
     onCpuPoll: () -> Unit,
     onGpuPoll: () -> Unit,
     onMemoryPoll: () -> Unit,
+    onPageCachePoll: () -> Unit,
     onDiskPoll: () -> Unit,
     onNetPoll: () -> Unit,
     onBatteryPoll: () -> Unit,
@@ -174,6 +176,19 @@ fun PerformanceScreen(
         }
     }
 
+    // Walks every process's maps, so far slower than the memory poll; the
+    // backend also serves a cached result inside its own refresh window.
+    LaunchedEffect(isMemoryActive, lifecycleOwner) {
+        if (isMemoryActive) {
+            lifecycleOwner.lifecycle.repeatOnLifecycle(androidx.lifecycle.Lifecycle.State.STARTED) {
+                while (isActive) {
+                    onPageCachePoll()
+                    delay(10_000)
+                }
+            }
+        }
+    }
+
     val isDiskActive = "disk" in activeCategoryIds
     LaunchedEffect(isDiskActive, lifecycleOwner) {
         if (isDiskActive) {
@@ -263,6 +278,7 @@ fun PerformanceScreen(
             val category = displayCategories.getOrNull(page) ?: selected
             MainPanel(
                 category = category,
+                pageCacheFiles = if (category.id == "memory") pageCacheFiles else emptyList(),
                 modifier = Modifier
                     .fillMaxSize()
                     .padding(horizontal = 16.dp, vertical = 12.dp)
@@ -349,15 +365,18 @@ private fun CategorySelectorItem(
 }
 
 @Composable
-private fun MainPanel(category: PerformanceCategory, modifier: Modifier = Modifier) {
+private fun MainPanel(
+    category: PerformanceCategory,
+    pageCacheFiles: List<PageCacheFile> = emptyList(),
+    modifier: Modifier = Modifier
+) {
     Column(modifier = modifier.verticalScroll(rememberScrollState())) {
         Header(category = category)
         Spacer(modifier = Modifier.height(8.dp))
         ChartBlock(category = category)
         Spacer(modifier = Modifier.height(16.dp))
 
-        // TODO: restore Memory composition block later
-        if (false) {
+        if (category.compositionSegments.isNotEmpty()) {
             category.compositionLabel?.let {
                 Text(
                     text = it,
@@ -372,6 +391,53 @@ private fun MainPanel(category: PerformanceCategory, modifier: Modifier = Modifi
 
         StatsBlock(category = category)
         Spacer(modifier = Modifier.height(20.dp))
+
+        if (pageCacheFiles.isNotEmpty()) {
+            PageCacheBlock(pageCacheFiles)
+            Spacer(modifier = Modifier.height(20.dp))
+        }
+    }
+}
+
+@Composable
+private fun PageCacheBlock(files: List<PageCacheFile>) {
+    Text(
+        text = "Hottest files in page cache",
+        color = SecondaryText,
+        style = MaterialTheme.typography.labelMedium
+    )
+    Spacer(modifier = Modifier.height(6.dp))
+    files.forEach { file ->
+        Row(
+            modifier = Modifier
+                .fillMaxWidth()
+                .padding(vertical = 4.dp),
+            verticalAlignment = Alignment.CenterVertically
+        ) {
+            Column(modifier = Modifier.weight(1f)) {
+                Text(
+                    text = file.path.substringAfterLast('/'),
+                    color = PrimaryText,
+                    style = MaterialTheme.typography.bodyMedium,
+                    maxLines = 1,
+                    overflow = TextOverflow.Ellipsis
+                )
+                Text(
+                    text = "${file.processes} process${if (file.processes == 1) "" else "es"} · ${file.path}",
+                    color = SecondaryText,
+                    style = MaterialTheme.typography.labelSmall,
+                    maxLines = 1,
+                    overflow = TextOverflow.Ellipsis
+                )
+            }
+            val pct = if (file.sizeBytes > 0) (file.cachedBytes * 100 / file.sizeBytes).coerceAtMost(100) else 0L
+            Text(
+                text = "${formatBytesMb(file.cachedBytes)} ($pct%)",
+                color = PrimaryText,
+                style = MaterialTheme.typography.labelLarge,
+                modifier = Modifier.padding(start = 8.dp)
+            )
+        }
     }
 }
 
@@ -864,21 +930,54 @@ private fun memoryCategoryFromSnapshot(
         "—"
     }
 
+    // In use without zram, zram's own RAM, then cache, as shares of total.
+    val total = snapshot.totalBytes.toFloat()
+    val composition = if (total > 0f) {
+        val zramShare = (snapshot.zramUsedBytes / total).coerceIn(0f, 1f)
+        val inUseShare = ((snapshot.usedBytes - snapshot.zramUsedBytes) / total).coerceIn(0f, 1f - zramShare)
+        val cachedShare = (snapshot.cachedBytes / total).coerceIn(0f, 1f - zramShare - inUseShare)
+        listOf(
+            inUseShare to base.seriesColor.copy(alpha = 0.38f),
+            zramShare to base.seriesColor.copy(alpha = 0.6f),
+            cachedShare to base.seriesColor.copy(alpha = 0.2f)
+        )
+    } else {
+        emptyList()
+    }
+
+    val swapText = if (snapshot.swapTotalBytes > 0) {
+        "${formatBytesGb(snapshot.swapUsedBytes)}/${formatBytesGb(snapshot.swapTotalBytes)}"
+    } else {
+        "—"
+    }
+    val zramMeta = if (snapshot.zramUsedBytes > 0) {
+        listOf(
+            StatItem("Compression ratio:", String.format("%.2fx", snapshot.zramRatio)),
+            StatItem("zram algorithm:", snapshot.zramAlgorithm.ifBlank { "—" })
+        )
+    } else {
+        emptyList()
+    }
+
     return base.copy(
         summaryText = summary,
         headerRightPrimary = totalGb,
         headerRightSecondary = formatBytesGb(snapshot.availableBytes),
         timeSeries = chartSeries,
+        compositionSegments = composition,
         leftStats = listOf(
-            StatItem("In use", formatBytesGb(snapshot.usedBytes)),
+            StatItem("In use (Compressed)", "${formatBytesGb(snapshot.usedBytes)} (${formatBytesGb(snapshot.compressedBytes)})"),
             StatItem("Committed", committedText),
-            StatItem("Cached", formatBytesGb(snapshot.cachedBytes))
+            StatItem("Cached", formatBytesGb(snapshot.cachedBytes)),
+            StatItem("Swap in", formatBytesPerSec(snapshot.swapInBytesPerSec))
         ),
         rightStats = listOf(
             StatItem("Available", formatBytesGb(snapshot.availableBytes)),
-            StatItem("Total", formatBytesGb(snapshot.totalBytes))
+            StatItem("Total", formatBytesGb(snapshot.totalBytes)),
+            StatItem("Swap", swapText),
+            StatItem("Swap out", formatBytesPerSec(snapshot.swapOutBytesPerSec))
         ),
-        metaStats = emptyList()
+        metaStats = zramMeta
     )
 }
 
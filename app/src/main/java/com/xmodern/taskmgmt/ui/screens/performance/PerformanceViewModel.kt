@@ -14,6 +14,7 @@ import kotlinx.coroutines.flow.MutableStateFlow
 import kotlinx.coroutines.flow.StateFlow
 import kotlinx.coroutines.flow.asStateFlow
 import kotlinx.coroutines.launch
+import org.json.JSONArray
 import org.json.JSONObject
 import java.net.Inet4Address
 import java.net.NetworkInterface
@@ -39,7 +40,94 @@ data class CpuSnapshot(
     val processes: Int,
     val threads: Int,
     val handles: Long,
-    val uptimeSeconds: Long
+    val uptimeSeconds: Long,
+    val cores: List<CpuCoreSnapshot> = emptyList(),
+    val clusters: List<CpuClusterSnapshot> = emptyList()
+)
+
+data class CpuCoreSnapshot(
+    val cpu: Int,
+    val online: Boolean,
+    // -1 while the core is offline.
+    val usagePercent: Double,
+    val freqKHz: Long,
+    // Index into CpuSnapshot.clusters (fastest first), -1 when unknown.
+    val cluster: Int
+)
+
+data class CpuClusterSnapshot(
+    val cpus: String,
+    val count: Int,
+    val online: Int,
+    val maxFreqKHz: Long,
+    val curFreqKHz: Long,
+    val usagePercent: Double,
+    val peakUsagePercent: Double,
+    val peakCpu: Int
+)
+
+data class FreqResidency(
+    val freqKHz: Long,
+    val fraction: Double
+)
+
+data class ClusterResidency(
+    val cpus: String,
+    val maxFreqKHz: Long,
+    // False when the kernel has no cpufreq stats for this policy.
+    val available: Boolean,
+    val avgFreqKHz: Long,
+    val freqResidency: List<FreqResidency>
+)
+
+data class IdleStateResidency(
+    val name: String,
+    val fraction: Double,
+    val entries: Long
+)
+
+data class CoreIdleResidency(
+    val cpu: Int,
+    val online: Boolean,
+    val cluster: Int,
+    // -1 until there are two samples to compare.
+    val activeFraction: Double,
+    val idleStates: List<IdleStateResidency>
+)
+
+// Where the cores spent the time between two polls; intervalMs is 0 on the first one.
+data class CpuResidencySnapshot(
+    val intervalMs: Long,
+    val clusters: List<ClusterResidency>,
+    val cores: List<CoreIdleResidency>
+)
+
+data class FrequencyCap(
+    // "cluster:<cpus>" or "devfreq:<device>"
+    val source: String,
+    val maxFreq: Long,
+    val capFreq: Long,
+    val cappedPercent: Double,
+    // "thermal" while a matched cooling device is engaged, "policy" for caps
+    // set by the user or power HAL, "none" when uncapped
+    val cause: String,
+    val coolingDevice: String,
+    val coolingState: Long
+)
+
+data class ThrottleEvent(
+    val seq: Long,
+    val timestampMs: Long,
+    val start: Boolean,
+    val source: String,
+    val detail: String
+)
+
+data class ThrottleSnapshot(
+    val caps: List<FrequencyCap>,
+    val activeCooling: List<String>,
+    // Most recent first.
+    val events: List<ThrottleEvent>
 )
 
 data class GpuSnapshot(
@@ -67,9 +155,37 @@ data class MemorySnapshot(
     val compressedBytes: Long,
     val committedUsedBytes: Long,
     val committedLimitBytes: Long,
+    val swapTotalBytes: Long,
+    val swapUsedBytes: Long,
+    val shmemBytes: Long,
+    val slabBytes: Long,
+    val kernelStackBytes: Long,
+    val pageTablesBytes: Long,
+    val unevictableBytes: Long,
+    // zram: data stored, RAM it costs, and their ratio
+    val zramOrigBytes: Long,
+    val zramUsedBytes: Long,
+    val zramRatio: Double,
+    val zramAlgorithm: String,
+    val swapInBytesPerSec: Long,
+    val swapOutBytesPerSec: Long,
+    // Per second, from /proc/vmstat deltas
+    val pageFaultRate: Double,
+    val majorFaultRate: Double,
+    val swapInRate: Double,
+    val swapOutRate: Double,
+    val reclaimScanRate: Double,
     val timestampMs: Long
 )
 
+// One module file from the system-wide page-cache view.
+data class PageCacheFile(
+    val path: String,
+    val sizeBytes: Long,
+    val cachedBytes: Long,
+    val processes: Int
+)
+
 data class DiskSnapshot(
     val totalBytes: Long,
     val usedBytes: Long,
@@ -135,6 +251,7 @@ data class MiniSnapshot(
 
 class PerformanceViewModel(application: Application) : AndroidViewModel(application) {
     private val rootManager = RootConnectionManager.getInstance(application)
+    private val residencyConsumer = rootManager.newResidencyConsumer()
     private var tempLogCounter = 0
 
     private val _cpuSnapshot = MutableStateFlow<CpuSnapshot?>(null)
@@ -143,6 +260,17 @@ class PerformanceViewModel(application: Application) : AndroidViewModel(applicat
     private val _cpuSeries = MutableStateFlow<List<Float>>(emptyList())
     val cpuSeries: StateFlow<List<Float>> = _cpuSeries.asStateFlow()
 
+    private val _cpuResidency = MutableStateFlow<CpuResidencySnapshot?>(null)
+    val cpuResidency: StateFlow<CpuResidencySnapshot?> = _cpuResidency.asStateFlow()
+
+    private val _throttle = MutableStateFlow<ThrottleSnapshot?>(null)
+    val throttle: StateFlow<ThrottleSnapshot?> = _throttle.asStateFlow()
+    private var throttleSeq = 0L
+
+    // One usage series per core, indexed by CPU number.
+    private val _coreSeries = MutableStateFlow<List<List<Float>>>(emptyList())
+    val coreSeries: StateFlow<List<List<Float>>> = _coreSeries.asStateFlow()
+
     private val _gpuSnapshot = MutableStateFlow<GpuSnapshot?>(null)
     val gpuSnapshot: StateFlow<GpuSnapshot?> = _gpuSnapshot.asStateFlow()
 
@@ -155,6 +283,10 @@ class PerformanceViewModel(application: Application) : AndroidViewModel(applicat
     private val _memorySeries = MutableStateFlow<List<Float>>(emptyList())
     val memorySeries: StateFlow<List<Float>> = _memorySeries.asStateFlow()
 
+    // Hottest files in the page cache across every process's mappings
+    private val _pageCacheFiles = MutableStateFlow<List<PageCacheFile>>(emptyList())
+    val pageCacheFiles: StateFlow<List<PageCacheFile>> = _pageCacheFiles.asStateFlow()
+
     private val _diskSnapshot = MutableStateFlow<DiskSnapshot?>(null)
     val diskSnapshot: StateFlow<DiskSnapshot?> = _diskSnapshot.asStateFlow()
 
@@ -194,6 +326,7 @@ class PerformanceViewModel(application: Application) : AndroidViewModel(applicat
     private var lastMiniNetTimestampMs: Long = 0
 
     private val seriesCapacity = 60
+    private val throttleEventCapacity = 64
 
     init {
         rootManager.bind()
@@ -225,7 +358,9 @@ class PerformanceViewModel(application: Application) : AndroidViewModel(applicat
                     processes = obj.optInt("processes", 0),
                     threads = obj.optInt("threads", 0),
                     handles = obj.optLong("handles", 0L),
-                    uptimeSeconds = obj.optLong("uptimeSeconds", 0L)
+                    uptimeSeconds = obj.optLong("uptimeSeconds", 0L),
+                    cores = parseCpuCores(obj.optJSONArray("cores")),
+                    clusters = parseCpuClusters(obj.optJSONArray("clusters"))
                 )
                 val friendly = SocNameMapper.resolve(getApplication(), snapshot.cpuName)
                 _cpuSnapshot.value = snapshot.copy(cpuDisplayName = friendly ?: snapshot.cpuName)
@@ -238,10 +373,101 @@ class PerformanceViewModel(application: Application) : AndroidViewModel(applicat
                 }
                 val clamped = snapshot.usagePercent.coerceIn(0.0, 100.0).toFloat()
                 pushSeries(_cpuSeries, clamped)
+                pushCoreSeries(snapshot.cores)
                 lastFullUpdatedMs["cpu"] = System.currentTimeMillis()
             } catch (e: Exception) {
                 Log.e("TaskManager", "CPU snapshot parse error", e)
             }
+            refreshCpuResidency()
+            refreshThrottle()
+        }
+    }
+
+    private fun refreshThrottle() {
+        val json = rootManager.getThermalThrottleJson(throttleSeq) ?: return
+        try {
+            val obj = JSONObject(json)
+            val caps = obj.optJSONArray("caps") ?: JSONArray()
+            val cooling = obj.optJSONArray("activeCooling") ?: JSONArray()
+            val events = obj.optJSONArray("events") ?: JSONArray()
+            val seq = obj.optLong("seq", 0L)
+            // A restarted service numbers events from zero again.
+            val previous = if (seq < throttleSeq) emptyList() else _throttle.value?.events.orEmpty()
+            val fresh = List(events.length()) { i ->
+                val e = events.getJSONObject(i)
+                ThrottleEvent(
+                    seq = e.optLong("seq", 0L),
+                    timestampMs = e.optLong("timestampMs", 0L),
+                    start = e.optString("kind", "") == "start",
+                    source = e.optString("source", ""),
+                    detail = e.optString("detail", "")
+                )
+            }
+            throttleSeq = seq
+            _throttle.value = ThrottleSnapshot(
+                caps = List(caps.length()) { i ->
+                    val c = caps.getJSONObject(i)
+                    FrequencyCap(
+                        source = c.optString("source", ""),
+                        maxFreq = c.optLong("maxFreq", 0L),
+                        capFreq = c.optLong("capFreq", 0L),
+                        cappedPercent = c.optDouble("cappedPercent", 0.0),
+                        cause = c.optString("cause", "none"),
+                        coolingDevice = c.optString("coolingDevice", ""),
+                        coolingState = c.optLong("coolingState", -1L)
+                    )
+                },
+                activeCooling = List(cooling.length()) { i -> cooling.getJSONObject(i).optString("type", "") },
+                events = (fresh.reversed() + previous).take(throttleEventCapacity)
+            )
+        } catch (e: Exception) {
+            Log.e("TaskManager", "Throttle parse error", e)
+        }
+    }
+
+    private fun refreshCpuResidency() {
+        val json = rootManager.getCpuResidencyJson(residencyConsumer) ?: return
+        try {
+            val obj = JSONObject(json)
+            val clusters = obj.optJSONArray("clusters") ?: JSONArray()
+            val cores = obj.optJSONArray("cores") ?: JSONArray()
+            _cpuResidency.value = CpuResidencySnapshot(
+                intervalMs = obj.optLong("intervalMs", 0L),
+                clusters = List(clusters.length()) { i ->
+                    val c = clusters.getJSONObject(i)
+                    val freqs = c.optJSONArray("freqResidency") ?: JSONArray()
+                    ClusterResidency(
+                        cpus = c.optString("cpus", ""),
+                        maxFreqKHz = c.optLong("maxFreqKHz", -1L),
+                        available = c.optBoolean("available", false),
+                        avgFreqKHz = c.optLong("avgFreqKHz", -1L),
+                        freqResidency = List(freqs.length()) { j ->
+                            val f = freqs.getJSONObject(j)
+                            FreqResidency(f.optLong("freqKHz", 0L), f.optDouble("fraction", 0.0))
+                        }
+                    )
+                },
+                cores = List(cores.length()) { i ->
+                    val c = cores.getJSONObject(i)
+                    val states = c.optJSONArray("idleStates") ?: JSONArray()
+                    CoreIdleResidency(
+                        cpu = c.optInt("cpu", i),
+                        online = c.optBoolean("online", false),
+                        cluster = c.optInt("cluster", -1),
+                        activeFraction = c.optDouble("activeFraction", -1.0),
+                        idleStates = List(states.length()) { j ->
+                            val s = states.getJSONObject(j)
+                            IdleStateResidency(
+                                s.optString("name", ""),
+                                s.optDouble("fraction", 0.0),
+                                s.optLong("entries", 0L)
+                            )
+                        }
+                    )
+                }
+            )
+        } catch (e: Exception) {
+            Log.e("TaskManager", "CPU residency parse error", e)
         }
     }
 
@@ -281,6 +507,8 @@ class PerformanceViewModel(application: Application) : AndroidViewModel(applicat
             val json = rootManager.getMemorySnapshotJson() ?: return@launch
             try {
                 val obj = JSONObject(json)
+                val rates = obj.optJSONObject("ratesPerSec")
+                val zram = obj.optJSONObject("zram")
                 val snapshot = MemorySnapshot(
                     totalBytes = obj.optLong("totalBytes", 0L),
                     usedBytes = obj.optLong("usedBytes", 0L),
@@ -289,6 +517,24 @@ class PerformanceViewModel(application: Application) : AndroidViewModel(applicat
                     compressedBytes = obj.optLong("compressedBytes", 0L),
                     committedUsedBytes = obj.optLong("committedUsedBytes", 0L),
                     committedLimitBytes = obj.optLong("committedLimitBytes", 0L),
+                    swapTotalBytes = obj.optLong("swapTotalBytes", 0L),
+                    swapUsedBytes = obj.optLong("swapUsedBytes", 0L),
+                    shmemBytes = obj.optLong("shmemBytes", 0L),
+                    slabBytes = obj.optLong("slabBytes", 0L),
+                    kernelStackBytes = obj.optLong("kernelStackBytes", 0L),
+                    pageTablesBytes = obj.optLong("pageTablesBytes", 0L),
+                    unevictableBytes = obj.optLong("unevictableBytes", 0L),
+                    zramOrigBytes = zram?.optLong("origDataBytes", 0L) ?: 0L,
+                    zramUsedBytes = zram?.optLong("memUsedTotalBytes", 0L) ?: 0L,
+                    zramRatio = zram?.optDouble("compressionRatio", 0.0) ?: 0.0,
+                    zramAlgorithm = zram?.optJSONArray("devices")?.optJSONObject(0)?.optString("algorithm", "") ?: "",
+                    swapInBytesPerSec = zram?.optLong("swapInBytesPerSec", 0L) ?: 0L,
+                    swapOutBytesPerSec = zram?.optLong("swapOutBytesPerSec", 0L) ?: 0L,
+                    pageFaultRate = rates?.optDouble("pgfault", 0.0) ?: 0.0,
+                    majorFaultRate = rates?.optDouble("pgmajfault", 0.0) ?: 0.0,
+                    swapInRate = rates?.optDouble("pswpin", 0.0) ?: 0.0,
+                    swapOutRate = rates?.optDouble("pswpout", 0.0) ?: 0.0,
+                    reclaimScanRate = rates?.optDouble("pgscan", 0.0) ?: 0.0,
                     timestampMs = obj.optLong("timestampMs", 0L)
                 )
                 _memorySnapshot.value = snapshot
@@ -306,6 +552,26 @@ class PerformanceViewModel(application: Application) : AndroidViewModel(applicat
         }
     }
 
+    fun refreshPageCacheFiles() {
+        viewModelScope.launch(Dispatchers.IO) {
+            val json = rootManager.getPageCacheTopJson(PAGE_CACHE_TOP_LIMIT) ?: return@launch
+            try {
+                val files = JSONObject(json).optJSONArray("files") ?: return@launch
+                _pageCacheFiles.value = (0 until files.length()).mapNotNull { i ->
+                    val f = files.optJSONObject(i) ?: return@mapNotNull null
+                    PageCacheFile(
+                        path = f.optString("path", ""),
+                        sizeBytes = f.optLong("sizeBytes", 0L),
+                        cachedBytes = f.optLong("cachedBytes", 0L),
+                        processes = f.optInt("processes", 0)
+                    )
+                }
+            } catch (e: Exception) {
+                Log.e("TaskManager", "Page cache parse error", e)
+            }
+        }
+    }
+
     fun refreshDiskSnapshot() {
         viewModelScope.launch(Dispatchers.IO) {
             val json = rootManager.getDiskSnapshotJson() ?: return@launch
@@ -542,6 +808,47 @@ class PerformanceViewModel(application: Application) : AndroidViewModel(applicat
         return rx to tx
     }
 
+    private fun parseCpuCores(arr: JSONArray?): List<CpuCoreSnapshot> {
+        if (arr == null) return emptyList()
+        return List(arr.length()) { i ->
+            val o = arr.getJSONObject(i)
+            CpuCoreSnapshot(
+                cpu = o.optInt("cpu", i),
+                online = o.optBoolean("online", false),
+                usagePercent = o.optDouble("usagePercent", -1.0),
+                freqKHz = o.optLong("freqKHz", -1L),
+                cluster = o.optInt("cluster", -1)
+            )
+        }
+    }
+
+    private fun parseCpuClusters(arr: JSONArray?): List<CpuClusterSnapshot> {
+        if (arr == null) return emptyList()
+        return List(arr.length()) { i ->
+            val o = arr.getJSONObject(i)
+            CpuClusterSnapshot(
+                cpus = o.optString("cpus", ""),
+                count = o.optInt("count", 0),
+                online = o.optInt("online", 0),
+                maxFreqKHz = o.optLong("maxFreqKHz", -1L),
+                curFreqKHz = o.optLong("curFreqKHz", -1L),
+                usagePercent = o.optDouble("usagePercent", -1.0),
+                peakUsagePercent = o.optDouble("peakUsagePercent", -1.0),
+                peakCpu = o.optInt("peakCpu", -1)
+            )
+        }
+    }
+
+    // Offline cores chart as 0 so every core keeps the same time axis.
+    private fun pushCoreSeries(cores: List<CpuCoreSnapshot>) {
+        val current = _coreSeries.value
+        _coreSeries.value = cores.map { core ->
+            val value = core.usagePercent.coerceIn(0.0, 100.0).toFloat()
+            val updated = (current.getOrNull(core.cpu).orEmpty() + value).takeLast(seriesCapacity)
+            if (updated.size < seriesCapacity) List(seriesCapacity - updated.size) { value } + updated else updated
+        }
+    }
+
     private fun pushSeries(flow: MutableStateFlow<List<Float>>, value: Float) {
         val current = flow.value
         val updated = (current + value).takeLast(seriesCapacity)
@@ -662,3 +969,5 @@ class PerformanceViewModel(application: Application) : AndroidViewModel(applicat
         rootManager.unbind()
     }
 }
+
+private const val PAGE_CACHE_TOP_LIMIT = 20
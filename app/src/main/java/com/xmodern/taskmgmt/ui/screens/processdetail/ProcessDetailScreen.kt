@@ -79,6 +79,7 @@ fun ProcessDetailScreen(
     onBack: () -> Unit
 ) {
     val processDetail by viewModel.selectedProcessDetails.collectAsState()
+    val showPageCache by viewModel.showModulePageCache.collectAsState()
     val tabs = listOf("Main", "Stats", "Modules", "Threads")
     val pagerState = rememberPagerState(pageCount = { tabs.size })
     val coroutineScope = rememberCoroutineScope()
@@ -228,7 +229,7 @@ fun ProcessDetailScreen(
                     when (page) {
                         0 -> OverviewTab(detail)
                         1 -> StatisticsTab(detail)
-                        2 -> ModulesTab(detail.modules)
+                        2 -> ModulesTab(detail.modules, showPageCache) { viewModel.toggleModulePageCache() }
                         3 -> ThreadsTab(detail.threadList)
                     }
                 }
@@ -282,27 +283,81 @@ fun StatisticsTab(detail: ProcessDetail) {
             DetailRow("Minor Page Faults", detail.minorPageFaults)
             DetailRow("Major Page Faults", detail.majorPageFaults)
         }
+
+        if (detail.memoryCategories.isNotEmpty()) {
+            DetailCard("Memory Breakdown (PSS / RSS)") {
+                detail.memoryCategories.forEach { category ->
+                    DetailRow(
+                        memoryCategoryLabel(category.name),
+                        "${formatKb(category.pssKb)} / ${formatKb(category.rssKb)}"
+                    )
+                }
+            }
+            DetailCard("Dirty & Swapped") {
+                detail.memoryCategories.forEach { category ->
+                    DetailRow(
+                        memoryCategoryLabel(category.name),
+                        "${formatKb(category.privateDirtyKb)} / ${formatKb(category.swapKb)}"
+                    )
+                }
+            }
+        }
     }
 }
 
+private fun memoryCategoryLabel(name: String): String = when (name) {
+    "JavaHeap" -> "Java Heap"
+    "NativeHeap" -> "Native Heap"
+    "Dex" -> "Dex / APK"
+    "OtherMmap" -> "Other mmap"
+    "OtherAnon" -> "Other anon"
+    else -> name
+}
+
+private fun formatKb(kb: Long): String = when {
+    kb >= 1024 * 1024 -> String.format("%.2f GB", kb / (1024.0 * 1024.0))
+    kb >= 1024 -> String.format("%.1f MB", kb / 1024.0)
+    else -> "$kb KB"
+}
+
 @Composable
-fun ModulesTab(modules: List<String>) {
+fun ModulesTab(modules: List<String>, showPageCache: Boolean, onTogglePageCache: () -> Unit) {
     val context = androidx.compose.ui.platform.LocalContext.current
     
     LazyColumn(
         modifier = Modifier.fillMaxSize(),
         contentPadding = PaddingValues(16.dp)
     ) {
+        item {
+            Row(
+                modifier = Modifier.fillMaxWidth(),
+                verticalAlignment = Alignment.CenterVertically
+            ) {
+                Text(
+                    text = "Show page cache residency",
+                    style = MaterialTheme.typography.bodyMedium,
+                    color = TextGrey,
+                    modifier = Modifier.weight(1f)
+                )
+                androidx.compose.material3.Switch(
+                    checked = showPageCache,
+                    onCheckedChange = { onTogglePageCache() }
+                )
+            }
+        }
 // ...
         if (modules.isEmpty()) {
             item { Text("No modules found or access denied.", color = TextGrey) }
         } else {
             items(modules) { moduleStr ->
-                // Format: Filename|FullPath|SizeBytes
+                // Format: Filename|FullPath|FileSizeBytes|RssBytes|PssBytes|Dev|Inode[|CachedBytes]
                 val parts = moduleStr.split("|")
                 val filename = parts.getOrNull(0) ?: "?"
                 val fullPath = parts.getOrNull(1) ?: "?"
                 val sizeBytes = parts.getOrNull(2)?.toLongOrNull() ?: 0L
+                val rssBytes = parts.getOrNull(3)?.toLongOrNull()
+                val pssBytes = parts.getOrNull(4)?.toLongOrNull()
+                val cachedBytes = parts.getOrNull(7)?.toLongOrNull()?.takeIf { it >= 0 }
 
                 Row(
                     modifier = Modifier
@@ -331,13 +386,33 @@ fun ModulesTab(modules: List<String>) {
                         )
                     }
 
-                    // RIGHT SIDE: Size
-                    Text(
-                        text = android.text.format.Formatter.formatFileSize(context, sizeBytes),
-                        style = MaterialTheme.typography.labelLarge,
-                        color = MaterialTheme.colorScheme.primary,
+                    // RIGHT SIDE: PSS, with RSS and file size beneath
+                    Column(
+                        horizontalAlignment = Alignment.End,
                         modifier = Modifier.padding(start = 8.dp)
-                    )
+                    ) {
+                        Text(
+                            text = android.text.format.Formatter.formatFileSize(context, pssBytes ?: sizeBytes),
+                            style = MaterialTheme.typography.labelLarge,
+                            color = MaterialTheme.colorScheme.primary
+                        )
+                        if (rssBytes != null) {
+                            Text(
+                                text = "RSS ${android.text.format.Formatter.formatFileSize(context, rssBytes)} · " +
+                                    "file ${android.text.format.Formatter.formatFileSize(context, sizeBytes)}",
+                                style = MaterialTheme.typography.bodySmall,
+                                color = TextGrey
+                            )
+                        }
+                        if (cachedBytes != null) {
+                            val cachedPct = if (sizeBytes > 0) (cachedBytes * 100 / sizeBytes).coerceAtMost(100) else 0L
+                            Text(
+                                text = "cached ${android.text.format.Formatter.formatFileSize(context, cachedBytes)} ($cachedPct%)",
+                                style = MaterialTheme.typography.bodySmall,
+                                color = TextGrey
+                            )
+                        }
+                    }
                 }
                 androidx.compose.material3.Divider(color = Color.DarkGray, thickness = 0.5.dp)
             }
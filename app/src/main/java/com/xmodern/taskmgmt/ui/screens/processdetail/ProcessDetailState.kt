@@ -2,6 +2,15 @@ package com.xmodern.taskmgmt.ui.screens.processdetail
 
 import android.graphics.drawable.Drawable
 
+// One smaps category of a process, in kB.
+data class MemoryCategoryUsage(
+    val name: String,
+    val rssKb: Long,
+    val pssKb: Long,
+    val privateDirtyKb: Long,
+    val swapKb: Long
+)
+
 data class ProcessDetail(
     val name: String = "",
     val label: String = "",
@@ -24,6 +33,7 @@ data class ProcessDetail(
     val nonVoluntaryCtxSwitches: String = "",
     val minorPageFaults: String = "",
     val majorPageFaults: String = "",
+    val memoryCategories: List<MemoryCategoryUsage> = emptyList(), // last entry is "Total"
     val modules: List<String> = emptyList(),
     val threadList: List<String> = emptyList() // Format: tid:priority:lastCpu:cpuShare:name
 )
@@ -29,6 +29,7 @@ import androidx.compose.material.icons.filled.ArrowBack
 import androidx.compose.material.icons.filled.Close
 import androidx.compose.material.icons.filled.MoreVert
 import androidx.compose.material.icons.filled.Search
+import androidx.compose.material3.AlertDialog
 import androidx.compose.material3.Divider
 import androidx.compose.material3.DropdownMenu
 import androidx.compose.material3.DropdownMenuItem
@@ -38,6 +39,7 @@ import androidx.compose.material3.IconButton
 import androidx.compose.material3.MaterialTheme
 import androidx.compose.material3.Scaffold
 import androidx.compose.material3.Text
+import androidx.compose.material3.TextButton
 import androidx.compose.material3.TextField
 import androidx.compose.material3.TextFieldDefaults
 import androidx.compose.material3.TopAppBar
@@ -49,6 +51,7 @@ import androidx.compose.runtime.getValue
 import androidx.compose.runtime.mutableStateOf
 import androidx.compose.runtime.remember
 import androidx.compose.runtime.setValue
+import androidx.compose.runtime.snapshotFlow
 import androidx.compose.ui.Alignment
 import androidx.compose.ui.Modifier
 import androidx.compose.ui.focus.FocusRequester
@@ -86,7 +89,9 @@ fun ProcessListScreen(
     val totalCpu by viewModel.totalCpuUsage.collectAsState()
     val totalRamUsed by viewModel.totalRamUsed.collectAsState()
     val totalRamSize by viewModel.totalRamSize.collectAsState()
+    val showPss by viewModel.showPss.collectAsState()
     val searchQuery by viewModel.searchQuery.collectAsState()
+    val memoryPressure by viewModel.memoryPressure.collectAsState()
     val context = LocalContext.current
 
     val layoutDirection = LocalLayoutDirection.current
@@ -94,6 +99,35 @@ fun ProcessListScreen(
     var isSearchActive by remember { mutableStateOf(false) }
     val focusRequester = remember { FocusRequester() }
 
+    if (memoryPressure) {
+        AlertDialog(
+            onDismissRequest = { viewModel.dismissMemoryPressure() },
+            title = { Text("Memory pressure") },
+            text = { Text("The system is stalling on memory. Review background apps to stop?") },
+            confirmButton = {
+                TextButton(onClick = {
+                    viewModel.dismissMemoryPressure()
+                    viewModel.scanForCandidates()
+                }) {
+                    Text("Review")
+                }
+            },
+            dismissButton = {
+                TextButton(onClick = { viewModel.dismissMemoryPressure() }) {
+                    Text("Dismiss")
+                }
+            },
+            containerColor = DarkSurface,
+            titleContentColor = TextWhite,
+            textContentColor = TextGrey
+        )
+    }
+
+    LaunchedEffect(listState) {
+        snapshotFlow { listState.layoutInfo.visibleItemsInfo.lastOrNull()?.index ?: 0 }
+            .collect { viewModel.onListScrolled(it) }
+    }
+
     Scaffold(
         topBar = {
             if (isSearchActive) {
@@ -196,6 +230,13 @@ fun ProcessListScreen(
                                     menuExpanded = false
                                 }
                             )
+                            DropdownMenuItem(
+                                text = { Text(if (showPss) "Show RSS" else "Show PSS") },
+                                onClick = {
+                                    viewModel.togglePss()
+                                    menuExpanded = false
+                                }
+                            )
                             Divider()
                             DropdownMenuItem(
                                 text = { Text("Safe Kill") },
@@ -8,7 +8,9 @@ import android.widget.Toast
 import androidx.lifecycle.AndroidViewModel
 import androidx.lifecycle.viewModelScope
 import com.xmodern.taskmgmt.domain.cache.AppInfoCache
+import com.xmodern.taskmgmt.domain.model.ProcessTable
 import com.xmodern.taskmgmt.service.RootConnectionManager
+import com.xmodern.taskmgmt.ui.screens.processdetail.MemoryCategoryUsage
 import com.xmodern.taskmgmt.ui.screens.processdetail.ProcessDetail
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.delay
@@ -19,6 +21,7 @@ import kotlinx.coroutines.flow.combine
 import kotlinx.coroutines.isActive
 import kotlinx.coroutines.launch
 import kotlinx.coroutines.withContext
+import org.json.JSONObject
 
 enum class SortOption {
     CPU, RAM, NAME, PRIORITY
@@ -33,6 +36,17 @@ data class KillCandidate(
 
 class ProcessListViewModel(application: Application) : AndroidViewModel(application) {
 
+    companion object {
+        private const val PAGE_SIZE = 40
+        private const val SAMPLER_INTERVAL_MS = 500L
+        // Each pressure wait holds one binder thread in the service; the
+        // backend caps it at 2 s.
+        private const val PRESSURE_WAIT_MS = 2_000L
+        private const val PRESSURE_RETRY_MS = 5_000L
+        // Per-scan time the backend may spend reading smaps_rollup.
+        private const val PSS_BUDGET_US = 5_000L
+    }
+
     // Raw list from C++
     private val _rawList = MutableStateFlow<List<RawProcessInfo>>(emptyList())
     
@@ -44,6 +58,14 @@ class ProcessListViewModel(application: Application) : AndroidViewModel(applicat
     private val _searchQuery = MutableStateFlow("")
     val searchQuery: StateFlow<String> = _searchQuery.asStateFlow()
     
+    // Memory column shows PSS (shared pages split between sharers) instead of RSS
+    private val _showPss = MutableStateFlow(false)
+    val showPss: StateFlow<Boolean> = _showPss.asStateFlow()
+
+    // Modules tab adds how much of each mapped file is in the page cache
+    private val _showModulePageCache = MutableStateFlow(false)
+    val showModulePageCache: StateFlow<Boolean> = _showModulePageCache.asStateFlow()
+
     // Global Stats
     private val _totalCpuUsage = MutableStateFlow(0.0)
     val totalCpuUsage: StateFlow<Double> = _totalCpuUsage.asStateFlow()
@@ -69,6 +91,11 @@ class ProcessListViewModel(application: Application) : AndroidViewModel(applicat
     private val _isReviewingKill = MutableStateFlow(false)
     val isReviewingKill: StateFlow<Boolean> = _isReviewingKill.asStateFlow()
 
+    // Set when the kernel reports a memory stall past the kill-flow trigger;
+    // ProcessListScreen prompts for a kill review and clears it.
+    private val _memoryPressure = MutableStateFlow(false)
+    val memoryPressure: StateFlow<Boolean> = _memoryPressure.asStateFlow()
+
     private val rootManager = RootConnectionManager.getInstance(application)
     private val appCache = AppInfoCache(application)
 
@@ -76,13 +103,27 @@ class ProcessListViewModel(application: Application) : AndroidViewModel(applicat
         Log.d("TaskManager", "ViewModel init")
         rootManager.bind()
         startPolling()
+        watchMemoryPressure()
         observeData()
     }
+
+    fun dismissMemoryPressure() {
+        _memoryPressure.value = false
+    }
     
     fun updateSortOption(option: SortOption) {
         _sortOption.value = option
     }
 
+    fun togglePss() {
+        _showPss.value = !_showPss.value
+        pssApplied = false
+    }
+
+    fun toggleModulePageCache() {
+        _showModulePageCache.value = !_showModulePageCache.value
+    }
+
     fun updateSearchQuery(query: String) {
         _searchQuery.value = query
     }
@@ -170,7 +211,7 @@ class ProcessListViewModel(application: Application) : AndroidViewModel(applicat
     fun fetchProcessDetails(pid: Int) {
         viewModelScope.launch(Dispatchers.IO) {
             // Use the new Deep Snapshot API
-            val data = rootManager.getProcessDeepSnapshot(pid)
+            val data = rootManager.getProcessDeepSnapshot(pid, _showModulePageCache.value)
             if (data != null) {
                 val rawDetail = parseProcessDetail(data)
                 val uiState = appCache.getAppUiState(rawDetail.name, this)
@@ -192,6 +233,7 @@ class ProcessListViewModel(application: Application) : AndroidViewModel(applicat
         val overviewMap = mutableMapOf<String, String>()
         val statsMap = mutableMapOf<String, String>()
         var modulesList = emptyList<String>()
+        var memoryCategories = emptyList<MemoryCategoryUsage>()
         var threadsList = emptyList<String>()
 
         for (section in sections) {
@@ -207,6 +249,14 @@ class ProcessListViewModel(application: Application) : AndroidViewModel(applicat
                     val parts = pair.split("=", limit = 2)
                     if (parts.size == 2) statsMap[parts[0]] = parts[1]
                 }
+            } else if (section.startsWith("MEMORY:")) {
+                // Name=rss:pss:privateDirty:swap, in kB
+                memoryCategories = section.substringAfter("MEMORY:").split("|").mapNotNull { entry ->
+                    val parts = entry.split("=", limit = 2)
+                    val values = parts.getOrNull(1)?.split(":")?.map { it.toLongOrNull() ?: 0L }
+                    if (values == null || values.size < 4) return@mapNotNull null
+                    MemoryCategoryUsage(parts[0], values[0], values[1], values[2], values[3])
+                }
             } else if (section.startsWith("MODULES:")) {
                 val content = section.substringAfter("MODULES:")
                 if (content.isNotEmpty()) {
@@ -240,6 +290,7 @@ class ProcessListViewModel(application: Application) : AndroidViewModel(applicat
             nonVoluntaryCtxSwitches = statsMap["NonVoluntaryCtxSwitches"] ?: "0",
             minorPageFaults = statsMap["MinorPageFaults"] ?: "0",
             majorPageFaults = statsMap["MajorPageFaults"] ?: "0",
+            memoryCategories = memoryCategories,
             modules = modulesList,
             threadList = threadsList
         )
@@ -248,23 +299,108 @@ class ProcessListViewModel(application: Application) : AndroidViewModel(applicat
     private fun startPolling() {
         viewModelScope.launch(Dispatchers.IO) {
             while (isActive) {
-                val rawData = rootManager.getProcessList()
-                if (rawData != null) {
-                    try {
-                        val parsed = parseProcessList(rawData)
-                        _rawList.emit(parsed)
+                // Once connected, let the backend sample on its own clock so
+                // polls only copy out its latest snapshot.
+                // Only the process scan is read here, so that is all it runs.
+                if (samplerId < 0) {
+                    samplerId = rootManager.startSampler(SAMPLER_INTERVAL_MS, RootConnectionManager.SAMPLE_PROCESSES)
+                }
+                if (!pssApplied) pssApplied = rootManager.setPssCollection(_showPss.value, PSS_BUDGET_US)
+                val sort = _sortOption.value
+                // Name sort and search work on app labels, which only exist on this side;
+                // every other view can be sorted and windowed by the backend.
+                val windowed = _searchQuery.value.isEmpty() && sort != SortOption.NAME
+                val table = if (windowed) {
+                    rootManager.queryProcessTable(
+                        sortKey = when (sort) {
+                            SortOption.CPU -> ProcessTable.SORT_CPU
+                            SortOption.RAM -> if (_showPss.value) ProcessTable.SORT_PSS else ProcessTable.SORT_RAM
+                            else -> ProcessTable.SORT_NICE
+                        },
+                        descending = sort != SortOption.PRIORITY,
+                        filter = "",
+                        offset = 0,
+                        limit = visibleLimit
+                    )
+                } else {
+                    rootManager.getProcessTable(listGeneration)
+                }
+                if (table != null) {
+                    _rawList.emit(applyProcessTable(table, windowed))
+                } else {
+                    // The service may come back as a new process with its own generations.
+                    listGeneration = 0L
+                    if (samplerId >= 0) rootManager.stopSampler(samplerId)
+                    samplerId = -1
+                    pssApplied = false
+                }
+                delay(500)
+            }
+        }
+    }
+
+    // The kernel trigger does the watching; this only parks in a long poll
+    // and wakes when an event arrives, so nothing samples memory counters.
+    private fun watchMemoryPressure() {
+        viewModelScope.launch(Dispatchers.IO) {
+            var armed = false
+            var pressureSeq = 0L
+            while (isActive) {
+                if (!armed) {
+                    armed = rootManager.armKillPressureTrigger() >= 0
+                    if (!armed) {
+                        delay(PRESSURE_RETRY_MS)
+                        continue
+                    }
+                    // Start from the backend's current seq: events it retained
+                    // from before this watcher (or this connection) are stale.
+                    // A sinceSeq ahead of the backend's returns at once with no events.
+                    val baseline = rootManager.waitPsiEvents(Long.MAX_VALUE, 0L)
+                    if (baseline == null) {
+                        armed = false
+                        delay(PRESSURE_RETRY_MS)
+                        continue
+                    }
+                    pressureSeq = try {
+                        JSONObject(baseline).optLong("seq", 0L)
                     } catch (e: Exception) {
-                        Log.e("TaskManager", "Error parsing process list", e)
+                        Log.e("TaskManager", "Error parsing pressure baseline", e)
+                        0L
                     }
+                } else if (rootManager.armKillPressureTrigger() < 0) {
+                    // The watcher drops a trigger the kernel tore down; arming
+                    // again re-registers it and is a no-op while it is live.
+                    armed = false
+                    delay(PRESSURE_RETRY_MS)
+                    continue
+                }
+                val json = rootManager.waitPsiEvents(pressureSeq, PRESSURE_WAIT_MS)
+                if (json == null) {
+                    // The service may come back as a new process without the trigger;
+                    // re-arming also re-reads the baseline seq.
+                    armed = false
+                    delay(PRESSURE_RETRY_MS)
+                    continue
+                }
+                try {
+                    val obj = JSONObject(json)
+                    pressureSeq = obj.optLong("seq", pressureSeq)
+                    val events = obj.optJSONArray("events") ?: continue
+                    for (i in 0 until events.length()) {
+                        if (events.getJSONObject(i).optString("resource") == "memory") {
+                            _memoryPressure.value = true
+                        }
+                    }
+                } catch (e: Exception) {
+                    Log.e("TaskManager", "Error parsing pressure events", e)
                 }
-                delay(500)
             }
         }
     }
 
     private fun observeData() {
         viewModelScope.launch {
-            combine(_rawList, appCache.updates, _sortOption, _searchQuery) { raw, _, sort, query ->
+            combine(_rawList, appCache.updates, _sortOption, _searchQuery, _showPss) { raw, _, sort, query, pss ->
                 val uiList = raw.map { p ->
                     val uiState = appCache.getAppUiState(p.name, viewModelScope)
                     ProcessUiModel(
@@ -274,7 +410,7 @@ class ProcessListViewModel(application: Application) : AndroidViewModel(applicat
                         icon = uiState.icon,
                         isSystem = uiState.isSystem,
                         cpuUsage = p.cpuUsage,
-                        ramUsage = p.ramUsage,
+                        ramUsage = if (pss && p.pssBytes >= 0) p.pssBytes else p.ramUsage,
                         nice = p.nice
                     )
                 }.filter { 
@@ -306,60 +442,56 @@ class ProcessListViewModel(application: Application) : AndroidViewModel(applicat
         val name: String,
         val cpuUsage: Double,
         val ramUsage: Long,
-        val nice: Int
+        val nice: Int,
+        val pssBytes: Long
     )
 
-    private fun parseProcessList(data: String): List<RawProcessInfo> {
-        val list = mutableListOf<RawProcessInfo>()
-        if (data.isEmpty()) return list
-
-        val lines = data.split("\n")
-        
-        var startIndex = 0
-        if (lines.isNotEmpty() && lines[0].startsWith("HEAD|")) {
-            try {
-                val parts = lines[0].split("|")
-                if (parts.size >= 4) {
-                    _totalCpuUsage.value = parts[1].toDoubleOrNull() ?: 0.0
-                    _totalRamUsed.value = parts[2].toLongOrNull() ?: 0L
-                    _totalRamSize.value = parts[3].toLongOrNull() ?: 1L
-                }
-                startIndex = 1 
-            } catch (e: Exception) {
-                Log.e("TaskManager", "Error parsing HEAD", e)
-            }
+    // Rows as of listGeneration, keyed by PID; only the polling coroutine touches these.
+    private var listGeneration = 0L
+    @Volatile
+    private var samplerId = -1
+    @Volatile
+    private var pssApplied = false
+    private val rowsByPid = LinkedHashMap<Int, RawProcessInfo>()
+
+    // Rows requested from the backend when it sorts and windows the list; grows as the user scrolls.
+    @Volatile
+    private var visibleLimit = PAGE_SIZE
+    @Volatile
+    private var totalRows = 0
+
+    fun onListScrolled(lastVisibleIndex: Int) {
+        if (lastVisibleIndex + PAGE_SIZE / 4 >= visibleLimit && visibleLimit < totalRows) {
+            visibleLimit += PAGE_SIZE
         }
+    }
 
-        for (i in startIndex until lines.size) {
-            val line = lines[i]
-            if (line.isBlank()) continue
-            
-            val parts = line.split("|")
-            if (parts.size >= 4) {
-                try {
-                    val pid = parts[0].toInt()
-                    val name = parts[1]
-                    val ram = parts[2].toLongOrNull() ?: 0L
-                    val cpu = parts[3].toDoubleOrNull() ?: 0.0
-                    val nice = if (parts.size >= 5) parts[4].toIntOrNull() ?: 0 else 0
-                    
-                    list.add(RawProcessInfo(
-                        pid = pid,
-                        name = name,
-                        cpuUsage = cpu,
-                        ramUsage = ram,
-                        nice = nice
-                    ))
-                } catch (e: NumberFormatException) {
-                    // Ignore
-                }
-            }
+    private fun applyProcessTable(table: ProcessTable, windowed: Boolean): List<RawProcessInfo> {
+        _totalCpuUsage.value = table.globalCpu
+        _totalRamUsed.value = table.ramUsed
+        _totalRamSize.value = if (table.ramTotal > 0) table.ramTotal else 1L
+
+        if (!table.isDelta) rowsByPid.clear()
+        for (pid in table.removedPids) rowsByPid.remove(pid)
+        for (row in table.rows) {
+            rowsByPid[row.pid] = RawProcessInfo(
+                pid = row.pid,
+                name = row.name,
+                cpuUsage = row.cpuUsage,
+                ramUsage = row.ramBytes,
+                nice = row.nice,
+                pssBytes = row.pssBytes
+            )
         }
-        return list
+        // A window is not a base that later deltas can be applied to.
+        listGeneration = if (windowed) 0L else table.generation
+        totalRows = if (windowed) table.totalRows else rowsByPid.size
+        return rowsByPid.values.toList()
     }
 
     override fun onCleared() {
         super.onCleared()
+        if (samplerId >= 0) rootManager.stopSampler(samplerId)
         rootManager.unbind()
     }
 }